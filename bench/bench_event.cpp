@@ -0,0 +1,133 @@
+#include "nbkit/event.h"
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <vector>
+
+// Notify cost with state.range(0) subscribers: nbkit::Event (inline Delegates) vs the same event over std::function.
+// Each callback captures three pointers, past std::function's inline buffer, so those are heap-allocated.
+
+namespace
+{
+    template <typename... Args>
+    class FunctionEvent
+    {
+    private:
+        std::vector<std::function<void(Args...)>> callbacks_;
+
+    public:
+        void Subscribe(std::function<void(Args...)> callback) { callbacks_.push_back(std::move(callback)); }
+
+        void Notify(Args... args)
+        {
+            for (auto& callback : callbacks_)
+                callback(args...);
+        }
+    };
+
+    struct Listener
+    {
+        int64_t total = 0;
+
+        void OnValue(int value) { total += value; }
+    };
+
+    template <typename EventType>
+    void Subscribe(EventType& event, int64_t count, int64_t* sums, int64_t* weights, int64_t* calls)
+    {
+        for (int64_t i = 0; i < count; ++i)
+            event.Subscribe([sum = sums + i % 16, weight = weights + i % 16, calls](int value)
+            {
+                *sum += value * *weight;
+                ++*calls;
+            });
+    }
+
+    template <typename EventType>
+    void Notify(benchmark::State& state)
+    {
+        std::vector<int64_t> sums(16, 0);
+        std::vector<int64_t> weights(16, 1);
+        int64_t calls = 0;
+        EventType event;
+        Subscribe(event, state.range(0), sums.data(), weights.data(), &calls);
+
+        for (auto _ : state)
+        {
+            event.Notify(1);
+            benchmark::ClobberMemory();
+        }
+        benchmark::DoNotOptimize(calls);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename EventType, typename Callback>
+    void NotifyMember(benchmark::State& state, const Callback& make_callback)
+    {
+        std::vector<Listener> listeners(static_cast<size_t>(state.range(0)));
+        EventType event;
+        for (Listener& listener : listeners)
+            make_callback(event, listener);
+
+        for (auto _ : state)
+        {
+            event.Notify(1);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+static void BM_Event_NotifyFunction(benchmark::State& state) { Notify<FunctionEvent<int>>(state); }
+static void BM_Event_NotifyDelegate(benchmark::State& state) { Notify<nbkit::Event<int>>(state); }
+
+static void BM_Event_NotifyMemberFunction(benchmark::State& state)
+{
+    NotifyMember<FunctionEvent<int>>(state, [](FunctionEvent<int>& event, Listener& listener)
+    {
+        event.Subscribe(std::bind_front(&Listener::OnValue, &listener));
+    });
+}
+
+static void BM_Event_NotifyMemberDelegate(benchmark::State& state)
+{
+    NotifyMember<nbkit::Event<int>>(state, [](nbkit::Event<int>& event, Listener& listener)
+    {
+        event.Subscribe<&Listener::OnValue>(&listener);
+    });
+}
+
+static void BM_Event_SubscribeFunction(benchmark::State& state)
+{
+    int64_t sums[16] {};
+    int64_t weights[16] {};
+    int64_t calls = 0;
+    for (auto _ : state)
+    {
+        FunctionEvent<int> event;
+        Subscribe(event, state.range(0), sums, weights, &calls);
+        benchmark::DoNotOptimize(&event);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Event_SubscribeDelegate(benchmark::State& state)
+{
+    int64_t sums[16] {};
+    int64_t weights[16] {};
+    int64_t calls = 0;
+    for (auto _ : state)
+    {
+        nbkit::Event<int> event;
+        Subscribe(event, state.range(0), sums, weights, &calls);
+        benchmark::DoNotOptimize(&event);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Event_NotifyFunction)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(BM_Event_NotifyDelegate)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(BM_Event_NotifyMemberFunction)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(BM_Event_NotifyMemberDelegate)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK(BM_Event_SubscribeFunction)->Arg(1000);
+BENCHMARK(BM_Event_SubscribeDelegate)->Arg(1000);
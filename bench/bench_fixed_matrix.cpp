@@ -0,0 +1,69 @@
+#include "nbkit/fixed_matrix.h"
+#include "nbkit/matrix.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using nbkit::FixedMatrix;
+using nbkit::Matrix;
+
+// 3x3 convolution of a 256 x 256 float image with the kernel held in a Matrix or a FixedMatrix
+
+namespace
+{
+    constexpr size_t kSide = 256;
+
+    template <typename Kernel>
+    void Convolve(const Matrix<float>& image, const Kernel& kernel, Matrix<float>& out)
+    {
+        for (size_t y = 1; y + 1 < kSide; ++y)
+            for (size_t x = 1; x + 1 < kSide; ++x)
+            {
+                float sum = 0.0f;
+                for (size_t ky = 0; ky < kernel.GetSizeY(); ++ky)
+                    for (size_t kx = 0; kx < kernel.GetSizeX(); ++kx)
+                        sum += kernel.Get(kx, ky) * image.Get(x + kx - 1, y + ky - 1);
+                out.Get(x, y) = sum;
+            }
+    }
+
+    Matrix<float> MakeImage()
+    {
+        Matrix<float> image;
+        image.Resize(kSide, kSide);
+        for (size_t i = 0; i < kSide * kSide; ++i)
+            image.GetData()[i] = static_cast<float>(i % 17);
+        return image;
+    }
+}
+
+static void BM_FixedMatrix_ConvolveDynamicKernel(benchmark::State& state)
+{
+    const Matrix<float> image = MakeImage();
+    const Matrix<float> kernel(3, std::vector<float>{ 1, 2, 1, 2, 4, 2, 1, 2, 1 });
+    Matrix<float> out;
+    out.Resize(kSide, kSide);
+
+    for (auto _ : state)
+    {
+        Convolve(image, kernel, out);
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+static void BM_FixedMatrix_ConvolveFixedKernel(benchmark::State& state)
+{
+    const Matrix<float> image = MakeImage();
+    const FixedMatrix<float, 3, 3> kernel({ 1, 2, 1, 2, 4, 2, 1, 2, 1 });
+    Matrix<float> out;
+    out.Resize(kSide, kSide);
+
+    for (auto _ : state)
+    {
+        Convolve(image, kernel, out);
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+BENCHMARK(BM_FixedMatrix_ConvolveDynamicKernel)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FixedMatrix_ConvolveFixedKernel)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,65 @@
+#include "nbkit/log.h"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+using namespace nbkit::log;
+
+namespace
+{
+    // the signature asserts had before taking the condition as a template parameter
+    template <Channel Ch = Channel::kDefault, typename... Args>
+    void FunctionAssertWarning(std::function<bool()> condition, Args... args)
+    {
+        if (!condition())
+            Warning<Ch>(args...);
+    }
+}
+
+// every condition holds, so these measure the cost of checking an assert that doesn't fire
+
+static void BM_Assert_StdFunction(benchmark::State& state)
+{
+    int value = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        FunctionAssertWarning([&value]() { return value > 0; }, "value ", value);
+    }
+}
+
+static void BM_Assert_Callable(benchmark::State& state)
+{
+    int value = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        AssertWarning([&value]() { return value > 0; }, "value ", value);
+    }
+}
+
+static void BM_Assert_Bool(benchmark::State& state)
+{
+    int value = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        AssertWarning(value > 0, "value ", value);
+    }
+}
+
+static void BM_Assert_DisabledChannel(benchmark::State& state)
+{
+    int value = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(value);
+        AssertWarning<Channel::kDisabled>([&value]() { return value > 0; }, "value ", value);
+    }
+}
+
+BENCHMARK(BM_Assert_StdFunction);
+BENCHMARK(BM_Assert_Callable);
+BENCHMARK(BM_Assert_Bool);
+BENCHMARK(BM_Assert_DisabledChannel);
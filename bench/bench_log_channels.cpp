@@ -0,0 +1,73 @@
+#include "nbkit/log.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace nbkit::log;
+
+namespace
+{
+    // the check *Runtime calls did before the channel mask
+    bool LinearScanIsEnabled(Channel channel)
+    {
+        for (const auto& enabled : kEnabledChannels)
+            if (enabled == channel)
+                return true;
+        return false;
+    }
+}
+
+static void BM_ChannelCheck_LinearScan(benchmark::State& state)
+{
+    Channel channel = Channel::kDisabled;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(channel);
+        benchmark::DoNotOptimize(LinearScanIsEnabled(channel));
+    }
+}
+
+static void BM_ChannelCheck_Mask(benchmark::State& state)
+{
+    Channel channel = Channel::kDisabled;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(channel);
+        benchmark::DoNotOptimize(IsChannelEnabledRuntime(channel));
+    }
+}
+
+static void BM_DisabledChannel_RuntimeCall(benchmark::State& state)
+{
+    Channel channel = Channel::kDisabled;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(channel);
+        InfoRuntime(channel, "value ", 42);
+    }
+}
+
+static void BM_DisabledChannel_TogglingRuntimeCall(benchmark::State& state)
+{
+    DisableChannel(Channel::kChannel14);
+    Channel channel = Channel::kChannel14;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(channel);
+        InfoRuntime(channel, "value ", 42);
+    }
+    ResetChannels();
+}
+
+static void BM_DisabledChannel_TemplateCall(benchmark::State& state)
+{
+    DisableChannel(Channel::kChannel14);
+    for (auto _ : state)
+        Info<Channel::kChannel14>("value ", 42);
+    ResetChannels();
+}
+
+BENCHMARK(BM_ChannelCheck_LinearScan);
+BENCHMARK(BM_ChannelCheck_Mask);
+BENCHMARK(BM_DisabledChannel_RuntimeCall);
+BENCHMARK(BM_DisabledChannel_TogglingRuntimeCall);
+BENCHMARK(BM_DisabledChannel_TemplateCall);
@@ -0,0 +1,25 @@
+// Log config shared by every benchmark, many sparse channels so channel lookups have something to scan
+
+#pragma once
+#include <array>
+
+namespace nbkit::log
+{
+
+#define NBKIT_LOG_CHANNELS_OVERRIDE
+enum class Channel
+{
+    kDefault,
+    kChannel1, kChannel2, kChannel3, kChannel4, kChannel5, kChannel6, kChannel7,
+    kChannel8, kChannel9, kChannel10, kChannel11, kChannel12, kChannel13, kChannel14, kChannel15,
+    kDisabled,
+};
+
+inline constexpr std::array<Channel, 8> kEnabledChannels =
+{
+    Channel::kDefault,
+    Channel::kChannel2, Channel::kChannel4, Channel::kChannel6, Channel::kChannel8,
+    Channel::kChannel10, Channel::kChannel12, Channel::kChannel14,
+};
+
+}
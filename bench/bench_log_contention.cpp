@@ -0,0 +1,63 @@
+#include "nbkit/log.h"
+
+#include <benchmark/benchmark.h>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+
+using namespace nbkit::log;
+
+namespace
+{
+    // discards output but takes a lock on every call, like the stdio lock behind std::cout
+    class LockedNullBuf : public std::streambuf
+    {
+    private:
+        std::mutex mutex_;
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            std::lock_guard lock(mutex_);
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize count) override
+        {
+            std::lock_guard lock(mutex_);
+            return count;
+        }
+    };
+
+    LockedNullBuf null_buf;
+    std::streambuf* cout_buf = nullptr;
+
+    void RedirectCout(const benchmark::State&) { cout_buf = std::cout.rdbuf(&null_buf); }
+    void RestoreCout(const benchmark::State&) { std::cout.rdbuf(cout_buf); }
+
+    // the sync path before per-thread buffering: one stream call per fragment
+    template <typename... Args>
+    void FragmentedLog(Args... args)
+    {
+        std::cout << detail::kColorInfo << "[" << magic_enum::enum_name(Channel::kDefault) << "] ";
+        (std::cout << ... << args);
+        std::cout << detail::kColorReset << "\n";
+    }
+}
+
+static void BM_LogContention_Fragmented(benchmark::State& state)
+{
+    int i = 0;
+    for (auto _ : state)
+        FragmentedLog("worker ", state.thread_index(), " iteration ", ++i, " value ", 0.5);
+}
+
+static void BM_LogContention_ThreadBuffered(benchmark::State& state)
+{
+    int i = 0;
+    for (auto _ : state)
+        Info("worker ", state.thread_index(), " iteration ", ++i, " value ", 0.5);
+}
+
+BENCHMARK(BM_LogContention_Fragmented)->Setup(RedirectCout)->Teardown(RestoreCout)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+BENCHMARK(BM_LogContention_ThreadBuffered)->Setup(RedirectCout)->Teardown(RestoreCout)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
@@ -0,0 +1,202 @@
+#include "nbkit/log.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+using namespace nbkit::log;
+
+// Throughput and per call latency of the public logging calls, run with 1 to hardware_concurrency threads
+// and every output kind. Latency benchmarks time each call, so their totals include ~20ns of clock overhead.
+
+namespace
+{
+    enum Output : int64_t { kDevNull, kFile, kPipe };
+
+#ifndef _WIN32
+    /// writes into a pipe drained by a reader thread, like logging into `app | consumer`
+    class PipeSink : public Sink
+    {
+    private:
+        int fds_[2] = { -1, -1 };
+        std::thread reader_;
+
+    public:
+        PipeSink()
+        {
+            if (::pipe(fds_) != 0)
+                return;
+
+            reader_ = std::thread([read_fd = fds_[0]]()
+            {
+                char buffer[64 * 1024];
+                while (::read(read_fd, buffer, sizeof(buffer)) > 0) {}
+            });
+        }
+
+        ~PipeSink() override
+        {
+            if (fds_[1] >= 0)
+                ::close(fds_[1]);
+            if (reader_.joinable())
+                reader_.join();
+            if (fds_[0] >= 0)
+                ::close(fds_[0]);
+        }
+
+        void Write(std::string_view records) override
+        {
+            while (!records.empty())
+            {
+                const ssize_t written = ::write(fds_[1], records.data(), records.size());
+                if (written <= 0)
+                    return;
+                records.remove_prefix(static_cast<size_t>(written));
+            }
+        }
+    };
+#endif
+
+    const std::string kFilePath = "nbkit_bench_log.txt";
+    std::unique_ptr<Sink> output_sink;
+
+    void SetUpOutput(const benchmark::State& state)
+    {
+        switch (state.range(0))
+        {
+            case kDevNull: output_sink = std::make_unique<FileSink>("/dev/null", false); break;
+            case kFile:    output_sink = std::make_unique<FileSink>(kFilePath, false); break;
+#ifndef _WIN32
+            case kPipe:    output_sink = std::make_unique<PipeSink>(); break;
+#endif
+            default:       output_sink = std::make_unique<FileSink>("/dev/null", false); break;
+        }
+        SetSink(*output_sink);
+    }
+
+    void TearDownOutput(const benchmark::State&)
+    {
+        Flush();
+        SetSink(GetDefaultSink());
+        output_sink.reset();
+        std::remove(kFilePath.c_str());
+    }
+
+    void ConfigureThreads(benchmark::internal::Benchmark* benchmark)
+    {
+        const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        benchmark->ThreadRange(1, max_threads)->UseRealTime();
+    }
+
+    void ConfigureOutputs(benchmark::internal::Benchmark* benchmark)
+    {
+        ConfigureThreads(benchmark);
+        benchmark->ArgName("output")->Arg(kDevNull)->Arg(kFile)->Arg(kPipe)->Setup(SetUpOutput)->Teardown(TearDownOutput);
+    }
+
+    // times every call and reports percentiles in ns, averaged over threads
+    template <typename LogCall>
+    void MeasureLatency(benchmark::State& state, LogCall log_call)
+    {
+        std::vector<uint32_t> samples;
+        samples.reserve(1 << 20);
+
+        int i = 0;
+        for (auto _ : state)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            log_call(++i);
+            const auto end = std::chrono::steady_clock::now();
+            if (samples.size() < samples.capacity())
+                samples.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+
+        if (samples.empty())
+            return;
+
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&samples](double p) { return static_cast<double>(samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))]); };
+        state.counters["p50_ns"] = benchmark::Counter(percentile(0.50), benchmark::Counter::kAvgThreads);
+        state.counters["p99_ns"] = benchmark::Counter(percentile(0.99), benchmark::Counter::kAvgThreads);
+        state.counters["p999_ns"] = benchmark::Counter(percentile(0.999), benchmark::Counter::kAvgThreads);
+        state.counters["max_ns"] = benchmark::Counter(static_cast<double>(samples.back()), benchmark::Counter::kAvgThreads);
+    }
+}
+
+//------ throughput
+
+static void BM_Throughput_Info(benchmark::State& state)
+{
+    int i = 0;
+    for (auto _ : state)
+        Info<Channel::kDefault>("iteration ", ++i, " value ", 0.5);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Throughput_InfoRuntime(benchmark::State& state)
+{
+    Channel channel = Channel::kDefault;
+    int i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(channel);
+        InfoRuntime(channel, "iteration ", ++i, " value ", 0.5);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+//------ latency
+
+static void BM_Latency_Info(benchmark::State& state)
+{
+    MeasureLatency(state, [](int i) { Info<Channel::kDefault>("iteration ", i, " value ", 0.5); });
+}
+
+static void BM_Latency_InfoRuntime(benchmark::State& state)
+{
+    Channel channel = Channel::kDefault;
+    MeasureLatency(state, [&channel](int i)
+    {
+        benchmark::DoNotOptimize(channel);
+        InfoRuntime(channel, "iteration ", i, " value ", 0.5);
+    });
+}
+
+static void BM_Latency_DisabledChannel(benchmark::State& state)
+{
+    Channel channel = Channel::kDisabled;
+    MeasureLatency(state, [&channel](int i)
+    {
+        benchmark::DoNotOptimize(channel);
+        Info<Channel::kDisabled>("iteration ", i, " value ", 0.5);
+        InfoRuntime(channel, "iteration ", i, " value ", 0.5);
+    });
+}
+
+static void BM_Latency_AssertHolds(benchmark::State& state)
+{
+    MeasureLatency(state, [](int i) { AssertWarning(i > 0, "iteration ", i); });
+}
+
+static void BM_Latency_AssertFires(benchmark::State& state)
+{
+    MeasureLatency(state, [](int i) { AssertWarning(i < 0, "iteration ", i); });
+}
+
+BENCHMARK(BM_Throughput_Info)->Apply(ConfigureOutputs);
+BENCHMARK(BM_Throughput_InfoRuntime)->Apply(ConfigureOutputs);
+BENCHMARK(BM_Latency_Info)->Apply(ConfigureOutputs);
+BENCHMARK(BM_Latency_InfoRuntime)->Apply(ConfigureOutputs);
+BENCHMARK(BM_Latency_DisabledChannel)->Apply(ConfigureThreads);
+BENCHMARK(BM_Latency_AssertHolds)->Apply(ConfigureThreads);
+BENCHMARK(BM_Latency_AssertFires)->Apply(ConfigureOutputs);
@@ -0,0 +1,113 @@
+#include "nbkit/matrix.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+using nbkit::Matrix;
+
+// Summing a 256 x 256 int matrix (L2 resident) through Get, RowPtr and the flat storage. Also built with
+// NBKIT_MATRIX_BOUNDS_CHECK defined as nbkit_bench_bounds_check, to measure the cost of the checks.
+
+namespace
+{
+    constexpr size_t kSide = 256;
+
+    Matrix<int32_t> MakeMatrix()
+    {
+        Matrix<int32_t> matrix;
+        matrix.Resize(kSide, kSide);
+        for (size_t i = 0; i < kSide * kSide; ++i)
+            matrix.GetData()[i] = static_cast<int32_t>(i % 7);
+        return matrix;
+    }
+}
+
+static void BM_MatrixAccess_Get(benchmark::State& state)
+{
+    const Matrix<int32_t> matrix = MakeMatrix();
+
+    for (auto _ : state)
+    {
+        int32_t sum = 0;
+        for (size_t y = 0; y < matrix.GetSizeY(); ++y)
+            for (size_t x = 0; x < matrix.GetSizeX(); ++x)
+                sum += matrix.Get(x, y);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kSide * kSide);
+}
+
+// four neighbours per cell, the checks can't all be proven from the loop bounds
+static void BM_MatrixAccess_GetNeighbours(benchmark::State& state)
+{
+    const Matrix<int32_t> matrix = MakeMatrix();
+
+    for (auto _ : state)
+    {
+        int32_t sum = 0;
+        for (size_t y = 1; y + 1 < matrix.GetSizeY(); ++y)
+            for (size_t x = 1; x + 1 < matrix.GetSizeX(); ++x)
+                sum += matrix.Get(x - 1, y) + matrix.Get(x + 1, y) + matrix.Get(x, y - 1) + matrix.Get(x, y + 1);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (kSide - 2) * (kSide - 2));
+}
+
+static void BM_MatrixAccess_RowPtrNeighbours(benchmark::State& state)
+{
+    const Matrix<int32_t> matrix = MakeMatrix();
+
+    for (auto _ : state)
+    {
+        int32_t sum = 0;
+        for (size_t y = 1; y + 1 < matrix.GetSizeY(); ++y)
+        {
+            const int32_t* above = matrix.RowPtr(y - 1);
+            const int32_t* row = matrix.RowPtr(y);
+            const int32_t* below = matrix.RowPtr(y + 1);
+            for (size_t x = 1; x + 1 < matrix.GetSizeX(); ++x)
+                sum += row[x - 1] + row[x + 1] + above[x] + below[x];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (kSide - 2) * (kSide - 2));
+}
+
+static void BM_MatrixAccess_RowPtr(benchmark::State& state)
+{
+    const Matrix<int32_t> matrix = MakeMatrix();
+
+    for (auto _ : state)
+    {
+        int32_t sum = 0;
+        for (size_t y = 0; y < matrix.GetSizeY(); ++y)
+        {
+            const int32_t* row = matrix.RowPtr(y);
+            for (size_t x = 0; x < matrix.GetSizeX(); ++x)
+                sum += row[x];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kSide * kSide);
+}
+
+static void BM_MatrixAccess_Flat(benchmark::State& state)
+{
+    const Matrix<int32_t> matrix = MakeMatrix();
+
+    for (auto _ : state)
+    {
+        int32_t sum = 0;
+        const int32_t* data = matrix.GetData();
+        for (size_t i = 0; i < kSide * kSide; ++i)
+            sum += data[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kSide * kSide);
+}
+
+BENCHMARK(BM_MatrixAccess_Get)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatrixAccess_GetNeighbours)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatrixAccess_RowPtrNeighbours)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatrixAccess_RowPtr)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatrixAccess_Flat)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,81 @@
+#include "nbkit/matrix.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using nbkit::Matrix;
+
+// Building a float matrix of state.range(0) rows of 16 elements row by row, then resizing a large one
+
+namespace
+{
+    constexpr size_t kWidth = 16;
+}
+
+static void BM_MatrixGrowth_AppendRow(benchmark::State& state)
+{
+    const std::vector<float> row(kWidth, 1.0f);
+
+    for (auto _ : state)
+    {
+        Matrix<float> matrix;
+        for (int64_t y = 0; y < state.range(0); ++y)
+            matrix.AppendRow(row);
+        benchmark::DoNotOptimize(matrix.GetData());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MatrixGrowth_ReservedAppendRow(benchmark::State& state)
+{
+    const std::vector<float> row(kWidth, 1.0f);
+
+    for (auto _ : state)
+    {
+        Matrix<float> matrix(kWidth);
+        matrix.Clear();
+        matrix.ReserveRows(static_cast<size_t>(state.range(0)));
+        for (int64_t y = 0; y < state.range(0); ++y)
+            matrix.AppendRow(row);
+        benchmark::DoNotOptimize(matrix.GetData());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MatrixGrowth_IncreaseSizeY(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Matrix<float> matrix(kWidth);
+        for (int64_t y = 1; y < state.range(0); ++y)
+            matrix.IncreaseSizeY();
+        benchmark::DoNotOptimize(matrix.GetData());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MatrixGrowth_Resize(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Matrix<float> matrix;
+        matrix.Resize(kWidth, static_cast<size_t>(state.range(0)));
+        benchmark::DoNotOptimize(matrix.GetData());
+    }
+}
+
+static void BM_MatrixGrowth_ResizeUninitialized(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Matrix<float> matrix;
+        matrix.ResizeUninitialized(kWidth, static_cast<size_t>(state.range(0)));
+        benchmark::DoNotOptimize(matrix.GetData());
+    }
+}
+
+BENCHMARK(BM_MatrixGrowth_AppendRow)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_MatrixGrowth_ReservedAppendRow)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_MatrixGrowth_IncreaseSizeY)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_MatrixGrowth_Resize)->Arg(1 << 20);
+BENCHMARK(BM_MatrixGrowth_ResizeUninitialized)->Arg(1 << 20);
@@ -0,0 +1,73 @@
+#include "nbkit/matrix_io.h"
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <string>
+
+using nbkit::MappedMatrix;
+using nbkit::Matrix;
+
+// Opening a saved float matrix through LoadMatrix and MappedMatrix, the side is state.range(0)
+
+namespace
+{
+    std::filesystem::path GetMatrixFile(size_t side)
+    {
+        const auto path = std::filesystem::temp_directory_path() / ("nbkit_bench_matrix_" + std::to_string(side) + ".nbm");
+        if (!std::filesystem::exists(path))
+        {
+            Matrix<float> matrix;
+            matrix.Resize(side, side);
+            for (size_t i = 0; i < side * side; ++i)
+                matrix.GetData()[i] = static_cast<float>(i % 1000);
+            nbkit::SaveMatrix(matrix, path);
+        }
+        return path;
+    }
+}
+
+static void BM_MatrixIo_Load(benchmark::State& state)
+{
+    const auto path = GetMatrixFile(static_cast<size_t>(state.range(0)));
+    Matrix<float> matrix;
+
+    for (auto _ : state)
+    {
+        nbkit::LoadMatrix(path, matrix);
+        benchmark::DoNotOptimize(matrix.GetData());
+    }
+}
+
+// opening only, pages are read on first access
+static void BM_MatrixIo_MapOpen(benchmark::State& state)
+{
+    const auto path = GetMatrixFile(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        MappedMatrix<float> mapped;
+        mapped.Open(path);
+        benchmark::DoNotOptimize(mapped.GetData());
+    }
+}
+
+// opening and touching one element per row
+static void BM_MatrixIo_MapOpenAndTouchRows(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto path = GetMatrixFile(side);
+
+    for (auto _ : state)
+    {
+        MappedMatrix<float> mapped;
+        mapped.Open(path);
+        float sum = 0.f;
+        for (size_t y = 0; y < side; ++y)
+            sum += mapped.Get(y, y);
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(BM_MatrixIo_Load)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatrixIo_MapOpen)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatrixIo_MapOpenAndTouchRows)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,96 @@
+#include "nbkit/matrix.h"
+
+#include <benchmark/benchmark.h>
+
+using nbkit::Matrix;
+using nbkit::MortonLayout;
+using nbkit::RowMajorLayout;
+using nbkit::TiledLayout;
+
+// Row walk, column walk and 3x3 stencil through Get on every layout, the side is state.range(0)
+
+namespace
+{
+    template <typename Layout>
+    Matrix<float, Layout> MakeMatrix(size_t side)
+    {
+        Matrix<float, Layout> matrix;
+        matrix.Resize(side, side);
+        for (size_t y = 0; y < side; ++y)
+            for (size_t x = 0; x < side; ++x)
+                matrix.Get(x, y) = static_cast<float>((x * 7 + y * 13) % 17);
+        return matrix;
+    }
+}
+
+template <typename Layout>
+static void BM_MatrixLayout_RowWalk(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto matrix = MakeMatrix<Layout>(side);
+
+    for (auto _ : state)
+    {
+        float sum = 0.f;
+        for (size_t y = 0; y < side; ++y)
+            for (size_t x = 0; x < side; ++x)
+                sum += matrix.Get(x, y);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+}
+
+template <typename Layout>
+static void BM_MatrixLayout_ColumnWalk(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto matrix = MakeMatrix<Layout>(side);
+
+    for (auto _ : state)
+    {
+        float sum = 0.f;
+        for (size_t x = 0; x < side; ++x)
+            for (size_t y = 0; y < side; ++y)
+                sum += matrix.Get(x, y);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+}
+
+template <typename Layout>
+static void BM_MatrixLayout_Stencil3x3(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto input = MakeMatrix<Layout>(side);
+    auto output = MakeMatrix<Layout>(side);
+
+    for (auto _ : state)
+    {
+        for (size_t y = 1; y + 1 < side; ++y)
+        {
+            for (size_t x = 1; x + 1 < side; ++x)
+            {
+                float sum = 0.f;
+                for (size_t dy = 0; dy < 3; ++dy)
+                    for (size_t dx = 0; dx < 3; ++dx)
+                        sum += input.Get(x + dx - 1, y + dy - 1);
+                output.Get(x, y) = sum * (1.f / 9.f);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>((side - 2) * (side - 2)));
+}
+
+#define NBKIT_BENCH_LAYOUT(Function, ...) \
+    BENCHMARK_TEMPLATE(Function, __VA_ARGS__)->Arg(256)->Arg(1024)->Arg(4096)
+
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_RowWalk, RowMajorLayout);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_RowWalk, TiledLayout<64, 64>);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_RowWalk, MortonLayout<64>);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_ColumnWalk, RowMajorLayout);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_ColumnWalk, TiledLayout<64, 64>);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_ColumnWalk, MortonLayout<64>);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_Stencil3x3, RowMajorLayout);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_Stencil3x3, TiledLayout<64, 64>);
+NBKIT_BENCH_LAYOUT(BM_MatrixLayout_Stencil3x3, MortonLayout<64>);
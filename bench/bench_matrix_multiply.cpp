@@ -0,0 +1,126 @@
+#include "nbkit/matrix_ops.h"
+
+#include <benchmark/benchmark.h>
+
+using nbkit::Matrix;
+
+// Naive loops over Get against matrix_ops::Multiply / Transpose on square matrices, the side is state.range(0)
+
+namespace
+{
+    Matrix<float> MakeMatrix(size_t side, size_t seed)
+    {
+        Matrix<float> matrix;
+        matrix.Resize(side, side);
+        for (size_t y = 0; y < side; ++y)
+            for (size_t x = 0; x < side; ++x)
+                matrix.Get(x, y) = static_cast<float>((x * 7 + y * 13 + seed) % 17) * 0.25f;
+        return matrix;
+    }
+
+    void SetFlops(benchmark::State& state, size_t side)
+    {
+        state.counters["flops"] = benchmark::Counter(2.0 * static_cast<double>(side * side * side),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    }
+}
+
+//================================== multiply
+
+static void BM_MatrixMultiply_Naive(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    const auto b = MakeMatrix(side, 1);
+    Matrix<float> out;
+    out.Resize(side, side);
+
+    for (auto _ : state)
+    {
+        for (size_t y = 0; y < side; ++y)
+            for (size_t x = 0; x < side; ++x)
+            {
+                float sum = 0.f;
+                for (size_t k = 0; k < side; ++k)
+                    sum += a.Get(k, y) * b.Get(x, k);
+                out.Get(x, y) = sum;
+            }
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    SetFlops(state, side);
+}
+
+static void BM_MatrixMultiply_Blocked(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    const auto b = MakeMatrix(side, 1);
+    Matrix<float> out;
+
+    for (auto _ : state)
+    {
+        nbkit::matrix_ops::Multiply(a, b, out);
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    SetFlops(state, side);
+}
+
+// the naive product at 4096 takes minutes, a single iteration is enough to compare
+BENCHMARK(BM_MatrixMultiply_Naive)->Arg(64)->Arg(512)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MatrixMultiply_Naive)->Arg(4096)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MatrixMultiply_Blocked)->Arg(64)->Arg(512)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+//================================== transpose
+
+static void BM_MatrixTranspose_Naive(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    Matrix<float> out;
+    out.Resize(side, side);
+
+    for (auto _ : state)
+    {
+        for (size_t y = 0; y < side; ++y)
+            for (size_t x = 0; x < side; ++x)
+                out.Get(y, x) = a.Get(x, y);
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+}
+
+static void BM_MatrixTranspose_Blocked(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    Matrix<float> out;
+
+    for (auto _ : state)
+    {
+        nbkit::matrix_ops::Transpose(a, out);
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+}
+
+static void BM_MatrixTranspose_InPlace(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    auto a = MakeMatrix(side, 0);
+
+    for (auto _ : state)
+    {
+        nbkit::matrix_ops::TransposeInPlace(a);
+        benchmark::DoNotOptimize(a.GetData());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+}
+
+BENCHMARK(BM_MatrixTranspose_Naive)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(BM_MatrixTranspose_Blocked)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(BM_MatrixTranspose_InPlace)->Arg(64)->Arg(512)->Arg(4096);
@@ -0,0 +1,89 @@
+#include "nbkit/matrix_parallel.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <thread>
+
+using nbkit::Matrix;
+using nbkit::ThreadPool;
+
+// Parallel algorithms on a 4096 x 4096 float matrix, state.range(0) is the number of cores used (pool workers + caller)
+
+namespace
+{
+    constexpr size_t kSide = 4096;
+
+    Matrix<float> MakeMatrix()
+    {
+        Matrix<float> matrix;
+        matrix.Resize(kSide, kSide);
+        for (size_t y = 0; y < kSide; ++y)
+            for (size_t x = 0; x < kSide; ++x)
+                matrix.Get(x, y) = static_cast<float>((x * 7 + y * 13) % 17) * 0.25f;
+        return matrix;
+    }
+
+    const Matrix<float>& GetInput()
+    {
+        static const Matrix<float> matrix = MakeMatrix();
+        return matrix;
+    }
+
+    void ConfigureCores(benchmark::internal::Benchmark* benchmark)
+    {
+        const int max_cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        benchmark->ArgName("cores")->DenseRange(1, max_cores)->UseRealTime()->Unit(benchmark::kMillisecond);
+    }
+
+    void SetItems(benchmark::State& state)
+    {
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kSide * kSide));
+    }
+}
+
+// sqrt keeps the transform compute bound enough for the cores to matter
+static void BM_MatrixParallel_Transform(benchmark::State& state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(0)) - 1);
+    const auto& input = GetInput();
+    Matrix<float> out;
+
+    for (auto _ : state)
+    {
+        nbkit::matrix_ops::ParallelTransform(input, out, [](float value) { return std::sqrt(value) * 3.f + 1.f; }, pool);
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    SetItems(state);
+}
+
+static void BM_MatrixParallel_Reduce(benchmark::State& state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(0)) - 1);
+    const auto& input = GetInput();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(nbkit::matrix_ops::ParallelReduce(input, 0.0, [](double a, auto b) { return a + b; }, pool));
+    SetItems(state);
+}
+
+static void BM_MatrixParallel_ForEachRow(benchmark::State& state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(0)) - 1);
+    auto matrix = GetInput();
+
+    for (auto _ : state)
+    {
+        nbkit::matrix_ops::ParallelForEachRow(matrix, [](size_t y, std::span<float> row)
+        {
+            for (size_t x = 0; x < row.size(); ++x)
+                row[x] = row[x] * 0.5f + static_cast<float>(x ^ y);
+        }, pool);
+        benchmark::ClobberMemory();
+    }
+    SetItems(state);
+}
+
+BENCHMARK(BM_MatrixParallel_Transform)->Apply(ConfigureCores);
+BENCHMARK(BM_MatrixParallel_Reduce)->Apply(ConfigureCores);
+BENCHMARK(BM_MatrixParallel_ForEachRow)->Apply(ConfigureCores);
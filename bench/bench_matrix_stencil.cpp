@@ -0,0 +1,172 @@
+#include "nbkit/matrix_stencil.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+using nbkit::EdgePolicy;
+using nbkit::FixedMatrix;
+using nbkit::Matrix;
+namespace matrix_ops = nbkit::matrix_ops;
+
+// 5x5 blur and game of life step on a 1024 x 1024 grid: hand-written Get loop with clamped edges vs the stencil engine
+
+namespace
+{
+    constexpr size_t kSide = 1024;
+
+    const FixedMatrix<float, 5, 5> kBinomial({
+        1 / 256.f, 4 / 256.f, 6 / 256.f, 4 / 256.f, 1 / 256.f,
+        4 / 256.f, 16 / 256.f, 24 / 256.f, 16 / 256.f, 4 / 256.f,
+        6 / 256.f, 24 / 256.f, 36 / 256.f, 24 / 256.f, 6 / 256.f,
+        4 / 256.f, 16 / 256.f, 24 / 256.f, 16 / 256.f, 4 / 256.f,
+        1 / 256.f, 4 / 256.f, 6 / 256.f, 4 / 256.f, 1 / 256.f });
+
+    // same kernel with one tap nudged, so it isn't separable any more
+    const FixedMatrix<float, 5, 5> kNonSeparable = []
+    {
+        FixedMatrix<float, 5, 5> kernel = kBinomial;
+        kernel.Get(0, 0) = 2 / 256.f;
+        return kernel;
+    }();
+
+    Matrix<float> MakeImage()
+    {
+        Matrix<float> image;
+        image.Resize(kSide, kSide);
+        for (size_t i = 0; i < kSide * kSide; ++i)
+            image.GetData()[i] = static_cast<float>(i % 17);
+        return image;
+    }
+
+    Matrix<uint8_t> MakeBoard()
+    {
+        Matrix<uint8_t> board;
+        board.Resize(kSide, kSide);
+        for (size_t i = 0; i < kSide * kSide; ++i)
+            board.GetData()[i] = (i * 2654435761u >> 13) % 3 == 0 ? 1 : 0;
+        return board;
+    }
+
+    uint8_t LifeRule(int neighbours, uint8_t alive) { return neighbours == 3 || (neighbours == 2 && alive) ? 1 : 0; }
+}
+
+static void BM_Stencil_NaiveBlur(benchmark::State& state)
+{
+    const Matrix<float> image = MakeImage();
+    Matrix<float> out;
+    out.Resize(kSide, kSide);
+    const auto last = static_cast<std::ptrdiff_t>(kSide - 1);
+
+    for (auto _ : state)
+    {
+        for (std::ptrdiff_t y = 0; y <= last; ++y)
+            for (std::ptrdiff_t x = 0; x <= last; ++x)
+            {
+                float sum = 0.0f;
+                for (std::ptrdiff_t ky = 0; ky < 5; ++ky)
+                    for (std::ptrdiff_t kx = 0; kx < 5; ++kx)
+                    {
+                        const size_t sx = static_cast<size_t>(std::clamp<std::ptrdiff_t>(x + kx - 2, 0, last));
+                        const size_t sy = static_cast<size_t>(std::clamp<std::ptrdiff_t>(y + ky - 2, 0, last));
+                        sum += kBinomial.Get(kx, ky) * image.Get(sx, sy);
+                    }
+                out.Get(x, y) = sum;
+            }
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+static void BM_Stencil_ConvolveSeparable(benchmark::State& state)
+{
+    const Matrix<float> image = MakeImage();
+    Matrix<float> out;
+
+    for (auto _ : state)
+    {
+        matrix_ops::Convolve(image, kBinomial, out);
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+static void BM_Stencil_ConvolveDirect(benchmark::State& state)
+{
+    const Matrix<float> image = MakeImage();
+    Matrix<float> out;
+
+    for (auto _ : state)
+    {
+        matrix_ops::Convolve(image, kNonSeparable, out);
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+static void BM_Stencil_ConvolveInPlace(benchmark::State& state)
+{
+    Matrix<float> image = MakeImage();
+
+    for (auto _ : state)
+    {
+        matrix_ops::Convolve(image, kBinomial, image);
+        benchmark::DoNotOptimize(image.GetData());
+    }
+}
+
+static void BM_Stencil_ParallelConvolve(benchmark::State& state)
+{
+    const Matrix<float> image = MakeImage();
+    Matrix<float> out;
+
+    for (auto _ : state)
+    {
+        matrix_ops::ParallelConvolve(image, kBinomial, out);
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+static void BM_Stencil_NaiveLife(benchmark::State& state)
+{
+    const Matrix<uint8_t> board = MakeBoard();
+    Matrix<uint8_t> out;
+    out.Resize(kSide, kSide);
+
+    for (auto _ : state)
+    {
+        for (size_t y = 0; y < kSide; ++y)
+            for (size_t x = 0; x < kSide; ++x)
+            {
+                int neighbours = 0;
+                for (size_t sy = y == 0 ? 0 : y - 1; sy <= std::min(y + 1, kSide - 1); ++sy)
+                    for (size_t sx = x == 0 ? 0 : x - 1; sx <= std::min(x + 1, kSide - 1); ++sx)
+                        neighbours += board.Get(sx, sy);
+                out.Get(x, y) = LifeRule(neighbours - board.Get(x, y), board.Get(x, y));
+            }
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+static void BM_Stencil_Life(benchmark::State& state)
+{
+    const Matrix<uint8_t> board = MakeBoard();
+    Matrix<uint8_t> out;
+
+    for (auto _ : state)
+    {
+        matrix_ops::Stencil<3, 3, EdgePolicy::kZero>(board, out, [](const matrix_ops::StencilWindow<uint8_t, 3, 3>& window)
+        {
+            int neighbours = 0;
+            for (std::ptrdiff_t dy = -1; dy <= 1; ++dy)
+                for (std::ptrdiff_t dx = -1; dx <= 1; ++dx)
+                    neighbours += window.Get(dx, dy);
+            return LifeRule(neighbours - window.Get(0, 0), window.Get(0, 0));
+        });
+        benchmark::DoNotOptimize(out.GetData());
+    }
+}
+
+BENCHMARK(BM_Stencil_NaiveBlur)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Stencil_ConvolveSeparable)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Stencil_ConvolveDirect)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Stencil_ConvolveInPlace)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Stencil_ParallelConvolve)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Stencil_NaiveLife)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Stencil_Life)->Unit(benchmark::kMillisecond);
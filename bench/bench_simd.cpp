@@ -0,0 +1,146 @@
+#include "nbkit/matrix_ops.h"
+
+#include <benchmark/benchmark.h>
+
+using nbkit::Matrix;
+using nbkit::simd::SimdLevel;
+
+// Plain loops over Matrix iterators against matrix_ops at every simd level, the side is state.range(0)
+
+namespace
+{
+    Matrix<float> MakeMatrix(size_t side, size_t seed)
+    {
+        Matrix<float> matrix;
+        matrix.Resize(side, side);
+        for (size_t y = 0; y < side; ++y)
+            for (size_t x = 0; x < side; ++x)
+                matrix.Get(x, y) = static_cast<float>((x * 7 + y * 13 + seed) % 17) * 0.25f;
+        return matrix;
+    }
+
+    // skips the benchmark when the cpu doesn't support the level, restores the best level when done
+    class LevelScope
+    {
+    public:
+        LevelScope(benchmark::State& state, SimdLevel level)
+        {
+            if (nbkit::simd::SetSimdLevel(level) != level)
+                state.SkipWithError("simd level not supported");
+        }
+        ~LevelScope() { nbkit::simd::SetSimdLevel(nbkit::simd::GetSupportedSimdLevel()); }
+    };
+
+    void SetItems(benchmark::State& state, size_t side)
+    {
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+    }
+}
+
+//================================== plain loops
+
+static void BM_Simd_SumLoop(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+
+    for (auto _ : state)
+    {
+        float sum = 0.f;
+        for (float value : a)
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+    SetItems(state, side);
+}
+
+static void BM_Simd_DotLoop(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    const auto b = MakeMatrix(side, 1);
+
+    for (auto _ : state)
+    {
+        float sum = 0.f;
+        for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+            sum += *ia * *ib;
+        benchmark::DoNotOptimize(sum);
+    }
+    SetItems(state, side);
+}
+
+static void BM_Simd_AddLoop(benchmark::State& state)
+{
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    const auto b = MakeMatrix(side, 1);
+    auto out = MakeMatrix(side, 2);
+
+    for (auto _ : state)
+    {
+        auto io = out.begin();
+        for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib, ++io)
+            *io = *ia + *ib;
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    SetItems(state, side);
+}
+
+//================================== matrix_ops
+
+template <SimdLevel Level>
+static void BM_Simd_Sum(benchmark::State& state)
+{
+    LevelScope scope(state, Level);
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(nbkit::matrix_ops::Sum(a));
+    SetItems(state, side);
+}
+
+template <SimdLevel Level>
+static void BM_Simd_Dot(benchmark::State& state)
+{
+    LevelScope scope(state, Level);
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    const auto b = MakeMatrix(side, 1);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(nbkit::matrix_ops::Dot(a, b));
+    SetItems(state, side);
+}
+
+template <SimdLevel Level>
+static void BM_Simd_Add(benchmark::State& state)
+{
+    LevelScope scope(state, Level);
+    const auto side = static_cast<size_t>(state.range(0));
+    const auto a = MakeMatrix(side, 0);
+    const auto b = MakeMatrix(side, 1);
+    auto out = MakeMatrix(side, 2);
+
+    for (auto _ : state)
+    {
+        nbkit::matrix_ops::Add(a, b, out);
+        benchmark::DoNotOptimize(out.GetData());
+        benchmark::ClobberMemory();
+    }
+    SetItems(state, side);
+}
+
+// 64 fits in L1, 1024 in L2/L3, 4096 goes to memory
+#define NBKIT_BENCH_SIMD(name) \
+    BENCHMARK(BM_Simd_##name##Loop)->Arg(64)->Arg(1024)->Arg(4096); \
+    BENCHMARK_TEMPLATE(BM_Simd_##name, SimdLevel::kScalar)->Arg(64)->Arg(1024)->Arg(4096); \
+    BENCHMARK_TEMPLATE(BM_Simd_##name, SimdLevel::kSse2)->Arg(64)->Arg(1024)->Arg(4096); \
+    BENCHMARK_TEMPLATE(BM_Simd_##name, SimdLevel::kAvx2)->Arg(64)->Arg(1024)->Arg(4096); \
+    BENCHMARK_TEMPLATE(BM_Simd_##name, SimdLevel::kAvx512)->Arg(64)->Arg(1024)->Arg(4096)
+
+NBKIT_BENCH_SIMD(Sum);
+NBKIT_BENCH_SIMD(Dot);
+NBKIT_BENCH_SIMD(Add);
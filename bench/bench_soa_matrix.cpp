@@ -0,0 +1,57 @@
+#include "nbkit/soa_matrix.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+using nbkit::Matrix;
+using nbkit::SoaMatrix;
+
+// Summing the integer field of a 1024 x 1024 grid of cells, stored as a Matrix of structs or as a SoaMatrix
+
+namespace
+{
+    constexpr size_t kSide = 1024;
+
+    struct Cell
+    {
+        float height;
+        uint32_t type;
+        double cost;
+    };
+}
+
+static void BM_SoaMatrix_ArrayOfStructsFieldSum(benchmark::State& state)
+{
+    Matrix<Cell> grid;
+    grid.Resize(kSide, kSide);
+    for (Cell& cell : grid)
+        cell.type = 1;
+
+    for (auto _ : state)
+    {
+        uint32_t sum = 0;
+        for (const Cell& cell : grid)
+            sum += cell.type;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * kSide * kSide * sizeof(uint32_t));
+}
+
+static void BM_SoaMatrix_PlaneFieldSum(benchmark::State& state)
+{
+    SoaMatrix<float, uint32_t, double> grid(kSide, kSide);
+    for (uint32_t& type : grid.GetPlane<1>())
+        type = 1;
+
+    for (auto _ : state)
+    {
+        uint32_t sum = 0;
+        for (uint32_t type : grid.GetPlane<1>())
+            sum += type;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * kSide * kSide * sizeof(uint32_t));
+}
+
+BENCHMARK(BM_SoaMatrix_ArrayOfStructsFieldSum)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SoaMatrix_PlaneFieldSum)->Unit(benchmark::kMicrosecond);
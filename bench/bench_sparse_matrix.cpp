@@ -0,0 +1,110 @@
+#include "nbkit/sparse_matrix.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using nbkit::Matrix;
+using nbkit::SparseMatrix;
+
+// 4096 x 4096 float grid with 1% of the cells set, stored dense or sparse. The memory_bytes counter is the storage
+// each one holds.
+
+namespace
+{
+    constexpr size_t kSide = 4096;
+
+    std::vector<std::pair<size_t, size_t>> GetCells(size_t count)
+    {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<size_t> coordinate(0, kSide - 1);
+        std::vector<std::pair<size_t, size_t>> cells(count);
+        for (auto& cell : cells)
+            cell = { coordinate(random), coordinate(random) };
+        return cells;
+    }
+
+    const std::vector<std::pair<size_t, size_t>>& GetSetCells()
+    {
+        static const auto cells = GetCells(kSide * kSide / 100);
+        return cells;
+    }
+
+    const std::vector<std::pair<size_t, size_t>>& GetLookups()
+    {
+        static const auto cells = GetCells(1 << 16);
+        return cells;
+    }
+}
+
+static void BM_SparseMatrix_DenseRandomGet(benchmark::State& state)
+{
+    Matrix<float> matrix;
+    matrix.Resize(kSide, kSide);
+    for (const auto& [x, y] : GetSetCells())
+        matrix.Get(x, y) = 1.0f;
+
+    for (auto _ : state)
+    {
+        float sum = 0.0f;
+        for (const auto& [x, y] : GetLookups())
+            sum += matrix.Get(x, y);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * GetLookups().size());
+    state.counters["memory_bytes"] = static_cast<double>(kSide * kSide * sizeof(float));
+}
+
+static void BM_SparseMatrix_SparseRandomGet(benchmark::State& state)
+{
+    SparseMatrix<float> matrix(kSide, kSide);
+    for (const auto& [x, y] : GetSetCells())
+        matrix.Set(x, y, 1.0f);
+
+    for (auto _ : state)
+    {
+        float sum = 0.0f;
+        for (const auto& [x, y] : GetLookups())
+            sum += matrix.Get(x, y);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * GetLookups().size());
+    state.counters["memory_bytes"] = static_cast<double>(matrix.GetMemoryUsage());
+}
+
+// visiting the set cells: the dense matrix scans every cell
+static void BM_SparseMatrix_DenseScan(benchmark::State& state)
+{
+    Matrix<float> matrix;
+    matrix.Resize(kSide, kSide);
+    for (const auto& [x, y] : GetSetCells())
+        matrix.Get(x, y) = 1.0f;
+
+    for (auto _ : state)
+    {
+        float sum = 0.0f;
+        for (float value : matrix)
+            if (value != 0.0f)
+                sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void BM_SparseMatrix_SparseForEach(benchmark::State& state)
+{
+    SparseMatrix<float> matrix(kSide, kSide);
+    for (const auto& [x, y] : GetSetCells())
+        matrix.Set(x, y, 1.0f);
+
+    for (auto _ : state)
+    {
+        float sum = 0.0f;
+        matrix.ForEach([&](size_t, size_t, float value) { sum += value; });
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(BM_SparseMatrix_DenseRandomGet)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparseMatrix_SparseRandomGet)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparseMatrix_DenseScan)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparseMatrix_SparseForEach)->Unit(benchmark::kMicrosecond);
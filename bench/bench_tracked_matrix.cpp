@@ -0,0 +1,99 @@
+#include "nbkit/tracked_matrix.h"
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using nbkit::Matrix;
+using nbkit::TrackedMatrix;
+
+// A tick on a 4096 x 4096 float grid: state.range(0) random writes, then the changes are copied out ("uploaded"),
+// the whole grid for the plain matrix, only the dirty 64 x 64 tiles for the tracked one
+
+namespace
+{
+    constexpr size_t kSide = 4096;
+
+    std::vector<std::pair<size_t, size_t>> GetWrites(size_t count)
+    {
+        std::mt19937 random(7);
+        std::uniform_int_distribution<size_t> coordinate(0, kSide - 1);
+        std::vector<std::pair<size_t, size_t>> writes(count);
+        for (auto& write : writes)
+            write = { coordinate(random), coordinate(random) };
+        return writes;
+    }
+}
+
+static void BM_TrackedMatrix_PlainTick(benchmark::State& state)
+{
+    const auto writes = GetWrites(static_cast<size_t>(state.range(0)));
+    Matrix<float> matrix;
+    matrix.Resize(kSide, kSide);
+    std::vector<float> upload(kSide * kSide);
+
+    for (auto _ : state)
+    {
+        for (const auto& [x, y] : writes)
+            matrix.Get(x, y) += 1.0f;
+        std::memcpy(upload.data(), matrix.GetData(), kSide * kSide * sizeof(float));
+        benchmark::DoNotOptimize(upload.data());
+    }
+}
+
+static void BM_TrackedMatrix_TrackedTick(benchmark::State& state)
+{
+    const auto writes = GetWrites(static_cast<size_t>(state.range(0)));
+    TrackedMatrix<float> matrix(kSide, kSide);
+    std::vector<float> upload(kSide * kSide);
+
+    for (auto _ : state)
+    {
+        for (const auto& [x, y] : writes)
+            matrix.Get(x, y) += 1.0f;
+        const auto& grid = matrix.GetMatrix();
+        matrix.ForEachDirtyTile([&](size_t x0, size_t y0, size_t width, size_t height)
+        {
+            for (size_t y = y0; y < y0 + height; ++y)
+                std::memcpy(upload.data() + y * kSide + x0, &grid.Get(x0, y), width * sizeof(float));
+        });
+        matrix.ClearDirty();
+        benchmark::DoNotOptimize(upload.data());
+    }
+}
+
+// write path only
+static void BM_TrackedMatrix_PlainWrites(benchmark::State& state)
+{
+    const auto writes = GetWrites(static_cast<size_t>(state.range(0)));
+    Matrix<float> matrix;
+    matrix.Resize(kSide, kSide);
+
+    for (auto _ : state)
+    {
+        for (const auto& [x, y] : writes)
+            matrix.Get(x, y) += 1.0f;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_TrackedMatrix_TrackedWrites(benchmark::State& state)
+{
+    const auto writes = GetWrites(static_cast<size_t>(state.range(0)));
+    TrackedMatrix<float> matrix(kSide, kSide);
+
+    for (auto _ : state)
+    {
+        for (const auto& [x, y] : writes)
+            matrix.Get(x, y) += 1.0f;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TrackedMatrix_PlainTick)->Arg(100)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TrackedMatrix_TrackedTick)->Arg(100)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TrackedMatrix_PlainWrites)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TrackedMatrix_TrackedWrites)->Arg(10000)->Unit(benchmark::kMicrosecond);
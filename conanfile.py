@@ -6,7 +6,7 @@ import os
 class NbkitConan(ConanFile):
     
     settings = "os", "compiler", "build_type", "arch"
-    exports_sources = "CMakeLists.txt", "nbkit/*", "tests/*"
+    exports_sources = "CMakeLists.txt", "nbkit/*", "tests/*", "bench/*"
 
     def layout(self):
         cmake_layout(self)
@@ -16,6 +16,7 @@ class NbkitConan(ConanFile):
 
     def build_requirements(self):
         self.test_requires("gtest/1.15.0")
+        self.test_requires("benchmark/1.9.0")
 
     def generate(self):
         tc = CMakeToolchain(self)
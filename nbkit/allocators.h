@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace nbkit
+{
+    /// <summary>
+    /// Standard allocator returning Alignment-byte aligned memory, 64 by default so that storage starts on a cache line
+    /// and fits aligned vector loads up to AVX-512
+    /// </summary>
+    template <typename T, size_t Alignment = 64>
+    class AlignedAllocator
+    {
+        static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two at least alignof(T)");
+
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t { Alignment })); }
+        void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t { Alignment }); }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    };
+
+    /// <summary>
+    /// Standard allocator backing large blocks with 2 MB pages, which cuts TLB misses on big grids.
+    /// Blocks of at least kHugePageSize bytes are mapped with MAP_HUGETLB when the system has huge pages reserved,
+    /// otherwise mapped normally and flagged for transparent huge pages. Smaller blocks and non-Linux systems get
+    /// 64-byte aligned memory from operator new.
+    /// </summary>
+    template <typename T>
+    class HugePageAllocator
+    {
+    public:
+        using value_type = T;
+        static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+        HugePageAllocator() = default;
+        template <typename U>
+        HugePageAllocator(const HugePageAllocator<U>&) {}
+
+        T* allocate(size_t n)
+        {
+            const size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+            if (bytes >= kHugePageSize)
+            {
+                const size_t mapped = GetMappedSize(bytes);
+                void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p == MAP_FAILED)
+                {
+                    p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (p == MAP_FAILED)
+                        throw std::bad_alloc();
+                    madvise(p, mapped, MADV_HUGEPAGE);
+                }
+                return static_cast<T*>(p);
+            }
+#endif
+            return static_cast<T*>(::operator new(bytes, std::align_val_t { 64 }));
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            const size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+            if (bytes >= kHugePageSize)
+            {
+                munmap(p, GetMappedSize(bytes));
+                return;
+            }
+#endif
+            ::operator delete(p, std::align_val_t { 64 });
+        }
+
+        template <typename U>
+        bool operator==(const HugePageAllocator<U>&) const { return true; }
+
+    private:
+        static size_t GetMappedSize(size_t bytes) { return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize; }
+    };
+
+    /// <summary>
+    /// Bump allocator: allocations are carved one after the other from large blocks and are never freed one by one,
+    /// Reset releases them all at once. Meant for many short-lived matrices, through ArenaAllocator.
+    /// Not thread safe, and a growing container leaves its previous buffers behind until Reset.
+    /// </summary>
+    class Arena
+    {
+        // -------------------------------------------------------------------- fields
+    private:
+        static constexpr size_t kBlockAlignment = 64;
+
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> memory;
+            size_t size = 0;
+        };
+
+        size_t block_size_;
+        std::vector<Block> blocks_;
+        std::byte* current_ = nullptr;
+        size_t remaining_ = 0;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        explicit Arena(size_t block_size = 1024 * 1024) : block_size_(block_size) {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator = (const Arena&) = delete;
+
+        /// alignment must be a power of two up to 64
+        void* Allocate(size_t bytes, size_t alignment)
+        {
+            const size_t padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+            if (current_ == nullptr || padding + bytes > remaining_)
+            {
+                AddBlock(std::max(bytes, block_size_));
+                return Allocate(bytes, alignment);
+            }
+
+            std::byte* p = current_ + padding;
+            current_ = p + bytes;
+            remaining_ -= padding + bytes;
+            return p;
+        }
+
+        /// frees every allocation, whatever was allocated from the arena must be destroyed first
+        void Reset()
+        {
+            blocks_.clear();
+            current_ = nullptr;
+            remaining_ = 0;
+        }
+
+        /// bytes reserved from the system, padding and unused block tails included
+        size_t GetReservedSize() const
+        {
+            size_t size = 0;
+            for (const Block& block : blocks_)
+                size += block.size;
+            return size;
+        }
+
+    private:
+        void AddBlock(size_t size)
+        {
+            // operator new[] only guarantees the default alignment, the extra bytes let Allocate align any request
+            Block block { std::unique_ptr<std::byte[]>(new std::byte[size + kBlockAlignment]), size + kBlockAlignment };
+            current_ = block.memory.get();
+            remaining_ = block.size;
+            blocks_.push_back(std::move(block));
+        }
+    };
+
+    /// <summary>
+    /// Standard allocator drawing from an Arena, deallocate does nothing
+    /// </summary>
+    template <typename T>
+    class ArenaAllocator
+    {
+        static_assert(alignof(T) <= 64, "Arena allocations are aligned on 64 bytes at most");
+
+        template <typename U>
+        friend class ArenaAllocator;
+
+    private:
+        Arena* arena_ = nullptr;
+
+    public:
+        using value_type = T;
+
+        ArenaAllocator(Arena& arena) : arena_(&arena) {}
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(arena_->Allocate(n * sizeof(T), 64)); }
+        void deallocate(T*, size_t) {}
+
+        Arena& GetArena() const { return *arena_; }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena_ == other.arena_; }
+    };
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nbkit
+{
+    /// default capacity: four pointers, and at least a std::function of the same signature so one can always be
+    /// wrapped (its size varies between standard libraries, 32 bytes in libstdc++, 48 in libc++, 64 in MSVC's)
+    template <typename Signature, size_t Capacity = std::max(4 * sizeof(void*), sizeof(std::function<Signature>))>
+    class Delegate;
+
+    /// <summary>
+    /// Callable wrapper like std::function, but the callable always lives in an inline buffer of Capacity bytes:
+    /// constructing, copying and moving never allocate, and a callable that doesn't fit is a compile error rather than
+    /// a hidden heap allocation. Calling costs one indirect call. Callables that are trivially copyable (lambdas
+    /// capturing pointers and references, bound member functions) are copied with a memcpy, so arrays of delegates
+    /// relocate like plain structs. Bind<&Class::Method>(object) binds a member function without a trampoline object.
+    /// </summary>
+    template <typename R, typename... Args, size_t Capacity>
+    class Delegate<R(Args...), Capacity>
+    {
+        // -------------------------------------------------------------------- fields
+    private:
+        enum class Operation { kCopy, kMove, kDestroy };
+
+        using Invoker = R (*)(void* callable, Args&&... args);
+        using Manager = void (*)(Operation operation, void* destination, void* source);
+
+        alignas(std::max_align_t) unsigned char buffer_[Capacity];
+        Invoker invoke_ = nullptr;
+        // null when the callable is trivially copyable and destructible
+        Manager manage_ = nullptr;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        static constexpr size_t kCapacity = Capacity;
+
+        Delegate() = default;
+        Delegate(std::nullptr_t) {}
+
+        /// function names decay to function pointers
+        template <typename F>
+            requires (!std::is_same_v<std::decay_t<F>, Delegate> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        Delegate(F&& callable)
+        {
+            using Callable = std::decay_t<F>;
+            static_assert(sizeof(Callable) <= Capacity, "callable doesn't fit in the delegate, raise Capacity");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "over-aligned callables aren't supported");
+            static_assert(std::is_nothrow_move_constructible_v<Callable>, "callables must be nothrow move constructible");
+
+            new (buffer_) Callable(std::forward<F>(callable));
+            invoke_ = [](void* stored, Args&&... args) -> R
+            {
+                return std::invoke(*static_cast<Callable*>(stored), std::forward<Args>(args)...);
+            };
+            if constexpr (!std::is_trivially_copyable_v<Callable> || !std::is_trivially_destructible_v<Callable>)
+                manage_ = &Manage<Callable>;
+        }
+
+        /// delegate calling (object->*Method)(args...), object must outlive it
+        template <auto Method, typename Class>
+        static Delegate Bind(Class* object)
+        {
+            static_assert(std::is_member_function_pointer_v<decltype(Method)>, "Method must be a member function pointer");
+            Delegate delegate;
+            std::memcpy(delegate.buffer_, &object, sizeof(object));
+            delegate.invoke_ = [](void* stored, Args&&... args) -> R
+            {
+                Class* target;
+                std::memcpy(&target, stored, sizeof(target));
+                return std::invoke(Method, target, std::forward<Args>(args)...);
+            };
+            return delegate;
+        }
+
+        Delegate(const Delegate& other) : invoke_(other.invoke_), manage_(other.manage_)
+        {
+            CopyFrom(other, Operation::kCopy);
+        }
+
+        Delegate(Delegate&& other) noexcept : invoke_(other.invoke_), manage_(other.manage_)
+        {
+            CopyFrom(other, Operation::kMove);
+        }
+
+        /// copies into a temporary first, so a throwing copy of the callable leaves this delegate unchanged
+        Delegate& operator=(const Delegate& other)
+        {
+            if (this != &other)
+                *this = Delegate(other);
+            return *this;
+        }
+
+        Delegate& operator=(Delegate&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                invoke_ = other.invoke_;
+                manage_ = other.manage_;
+                CopyFrom(other, Operation::kMove);
+            }
+            return *this;
+        }
+
+        ~Delegate() { Reset(); }
+
+        explicit operator bool() const { return invoke_ != nullptr; }
+
+        R operator()(Args... args) const
+        {
+            assert(invoke_ != nullptr && "calling an empty delegate");
+            return invoke_(const_cast<unsigned char*>(buffer_), std::forward<Args>(args)...);
+        }
+
+        void Reset()
+        {
+            if (manage_ != nullptr)
+                manage_(Operation::kDestroy, buffer_, nullptr);
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+
+    private:
+        template <typename Callable>
+        static void Manage(Operation operation, void* destination, void* source)
+        {
+            switch (operation)
+            {
+            case Operation::kCopy:
+                new (destination) Callable(*static_cast<const Callable*>(source));
+                break;
+            case Operation::kMove:
+                new (destination) Callable(std::move(*static_cast<Callable*>(source)));
+                break;
+            case Operation::kDestroy:
+                static_cast<Callable*>(destination)->~Callable();
+                break;
+            }
+        }
+
+        void CopyFrom(const Delegate& other, Operation operation)
+        {
+            if (manage_ != nullptr)
+                manage_(operation, buffer_, const_cast<unsigned char*>(other.buffer_));
+            else if (invoke_ != nullptr)
+                std::memcpy(buffer_, other.buffer_, Capacity);
+        }
+    };
+}
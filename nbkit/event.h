@@ -1,20 +1,39 @@
 #pragma once
 
+#include "nbkit/delegate.h"
+
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace nbkit
 {
-    template <typename... Args>
-    class Event
+    /// <summary>
+    /// Callbacks notified in subscription order. They are stored as Delegates of Capacity bytes side by side in one
+    /// vector, so subscribing never allocates per callback and Notify walks contiguous memory with one indirect call each.
+    /// A callback must fit in Capacity, checked at compile time. Unlike the std::function this used to store, a lambda
+    /// capturing more than that no longer compiles: raise Capacity, or pass it wrapped in a std::function (which then
+    /// allocates as usual and always fits).
+    /// </summary>
+    template <size_t Capacity, typename... Args>
+    class EventWithCapacity
     {
+    public:
+        using Callback = Delegate<void(Args...), Capacity>;
+        static_assert(Capacity >= sizeof(std::function<void(Args...)>), "std::function callbacks must fit");
+
     //---------------------------------------------------------- fields
     private:
-        std::vector<std::function<void(Args...)>> callbacks_;
+        std::vector<Callback> callbacks_;
 
     //---------------------------------------------------------- methods
     public:
-        void Subscribe(std::function<void(Args...)> callback) { callbacks_.push_back(callback); }
+        void Subscribe(Callback callback) { callbacks_.push_back(std::move(callback)); }
+
+        /// subscribes object->Method, object must outlive the subscription
+        template <auto Method, typename Class>
+        void Subscribe(Class* object) { callbacks_.push_back(Callback::template Bind<Method>(object)); }
+
         void Clear() { callbacks_.clear(); }
 
         void Notify(Args... args)
@@ -23,4 +42,10 @@ namespace nbkit
                 callback(args...);
         }
     };
-}
\ No newline at end of file
+
+    /// event with Delegate's default capacity: four pointers, and never less than a std::function
+    template <typename... Args>
+    class Event : public EventWithCapacity<Delegate<void(Args...)>::kCapacity, Args...>
+    {
+    };
+}
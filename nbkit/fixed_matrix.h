@@ -0,0 +1,64 @@
+#pragma once
+
+#include "nbkit/matrix_view.h"
+
+#include <array>
+#include <span>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Matrix whose size is known at compile time, for small kernels and boards (3x3, 8x8...). Elements are stored
+    /// row-major inline in a std::array: no allocation, no runtime width, and loops over GetSizeX()/GetSizeY() have
+    /// constant bounds the compiler can unroll. Same Get/Row/iterator API as Matrix, usable in constant expressions.
+    /// </summary>
+    template <typename T, size_t Width, size_t Height>
+    class FixedMatrix
+    {
+        // -------------------------------------------------------------------- fields
+    private:
+        std::array<T, Width * Height> elements_ {};
+
+        // -------------------------------------------------------------------- methods
+    public:
+        constexpr FixedMatrix() = default;
+
+        /// elements in row-major order
+        constexpr explicit FixedMatrix(const std::array<T, Width * Height>& elements) : elements_(elements) {}
+
+        static constexpr size_t GetSizeX() { return Width; }
+        static constexpr size_t GetSizeY() { return Height; }
+
+        constexpr const T& Get(size_t x, size_t y) const { return elements_[Width * y + x]; }
+        constexpr T& Get(size_t x, size_t y) { return elements_[Width * y + x]; }
+
+        constexpr T* GetData() { return elements_.data(); }
+        constexpr const T* GetData() const { return elements_.data(); }
+
+        constexpr void Fill(const T& value) { elements_.fill(value); }
+
+        constexpr bool operator==(const FixedMatrix&) const = default;
+
+        // -------------------------------------------------------------------- views
+    public:
+        constexpr std::span<T, Width> Row(size_t y) { return std::span<T, Width>(elements_.data() + Width * y, Width); }
+        constexpr std::span<const T, Width> Row(size_t y) const { return std::span<const T, Width>(elements_.data() + Width * y, Width); }
+
+        constexpr StridedSpan<T> Col(size_t x) { return StridedSpan<T>(elements_.data() + x, Height, Width); }
+        constexpr StridedSpan<const T> Col(size_t x) const { return StridedSpan<const T>(elements_.data() + x, Height, Width); }
+
+        constexpr MatrixView<T> AsView() { return MatrixView<T>(elements_.data(), Width, Height, Width); }
+        constexpr MatrixView<const T> AsView() const { return MatrixView<const T>(elements_.data(), Width, Height, Width); }
+
+        // -------------------------------------------------------------------- begin / end
+        // storage is row-major, so plain pointers walk the rows top to bottom
+    public:
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        constexpr iterator begin() { return elements_.data(); }
+        constexpr iterator end() { return elements_.data() + Width * Height; }
+        constexpr const_iterator begin() const { return elements_.data(); }
+        constexpr const_iterator end() const { return elements_.data() + Width * Height; }
+    };
+}
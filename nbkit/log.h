@@ -1,20 +1,55 @@
 #pragma once
 
 #include <iostream>
+#include <string>
 #include <string_view>
 #include <array>
 #include <algorithm>
-#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <magic_enum.hpp>
 
+// levels usable in NBKIT_LOG_MIN_LEVEL
+#define NBKIT_LOG_LEVEL_VERBOSE 0
+#define NBKIT_LOG_LEVEL_INFO    1
+#define NBKIT_LOG_LEVEL_SPARKLE 2
+#define NBKIT_LOG_LEVEL_WARNING 3
+#define NBKIT_LOG_LEVEL_ERROR   4
+
 // try to include log config (allows user to override colors and channels)
 #ifdef NBKIT_LOG_CONFIG_HEADER_PATH
     #include NBKIT_LOG_CONFIG_HEADER_PATH
 #endif
 
+#ifndef NBKIT_LOG_MIN_LEVEL
+    #define NBKIT_LOG_MIN_LEVEL NBKIT_LOG_LEVEL_VERBOSE
+#endif
+
+#include "nbkit/log_async.h"
+#include "nbkit/log_binary.h"
+#include "nbkit/log_format.h"
+#include "nbkit/log_sinks.h"
+
 namespace nbkit::log
 {
 
+//================================== levels
+
+enum class Level
+{
+    kVerbose = NBKIT_LOG_LEVEL_VERBOSE,
+    kInfo    = NBKIT_LOG_LEVEL_INFO,
+    kSparkle = NBKIT_LOG_LEVEL_SPARKLE,
+    kWarning = NBKIT_LOG_LEVEL_WARNING,
+    kError   = NBKIT_LOG_LEVEL_ERROR
+};
+
+// levels below this one are compiled out
+inline constexpr Level kMinLevel = static_cast<Level>(NBKIT_LOG_MIN_LEVEL);
+
 //================================== optional user overrides
 
 #ifndef NBKIT_LOG_CHANNELS_OVERRIDE
@@ -35,33 +70,548 @@ namespace detail
 #endif
 }
 
+#ifndef NBKIT_LOG_ASYNC_QUEUE_SIZE
+    #define NBKIT_LOG_ASYNC_QUEUE_SIZE 4096
+#endif
+
+#ifndef NBKIT_LOG_BINARY_BUFFER_SIZE
+    #define NBKIT_LOG_BINARY_BUFFER_SIZE 65536
+#endif
+
+#if defined(NBKIT_LOG_FORMAT_JSON)
+    inline constexpr RecordFormat kRecordFormat = RecordFormat::kJson;
+#elif defined(NBKIT_LOG_FORMAT_LOGFMT)
+    inline constexpr RecordFormat kRecordFormat = RecordFormat::kLogfmt;
+#else
+    inline constexpr RecordFormat kRecordFormat = RecordFormat::kText;
+#endif
+
+#ifdef NBKIT_LOG_ASYNC_DROP_WHEN_FULL
+    inline constexpr QueueFullPolicy kAsyncQueueFullPolicy = QueueFullPolicy::kDrop;
+#else
+    inline constexpr QueueFullPolicy kAsyncQueueFullPolicy = QueueFullPolicy::kBlock;
+#endif
+
+#ifndef NBKIT_LOG_SINK_OVERRIDE
+    inline Sink& GetDefaultSink()
+    {
+        static StdoutSink sink;
+        return sink;
+    }
+#endif
+
+namespace detail
+{
+    constexpr const char* GetLevelColor(Level level)
+    {
+        switch (level)
+        {
+            case Level::kVerbose: return kColorVerbose;
+            case Level::kInfo:    return kColorInfo;
+            case Level::kSparkle: return kColorSparkle;
+            case Level::kWarning: return kColorWarning;
+            case Level::kError:   return kColorError;
+        }
+        return kColorReset;
+    }
+
+    constexpr std::string_view GetLevelName(Level level)
+    {
+        switch (level)
+        {
+            case Level::kVerbose: return "verbose";
+            case Level::kInfo:    return "info";
+            case Level::kSparkle: return "sparkle";
+            case Level::kWarning: return "warning";
+            case Level::kError:   return "error";
+        }
+        return "unknown";
+    }
+
+    // timestamp and thread id are only taken when they are going to be written
+    template <Level L>
+    RecordInfo MakeRecordInfo(std::string_view channel, const CallSite& site)
+    {
+        RecordInfo info;
+        info.level = GetLevelName(L);
+        info.channel = channel;
+        if constexpr (kRecordFormat != RecordFormat::kText)
+        {
+            info.timestamp_ns = GetMonotonicNs();
+            info.thread_id = GetLogThreadId();
+            info.site = site;
+        }
+        return info;
+    }
+}
+
+//================================== sinks
+
+namespace detail
+{
+    inline std::atomic<Sink*>& GetSinkSlot()
+    {
+        static std::atomic<Sink*> sink { &GetDefaultSink() };
+        return sink;
+    }
+
+    /// forwards to the current sink, lets the async and binary backends follow SetSink
+    class CurrentSink : public Sink
+    {
+    public:
+        void Write(std::string_view records) override { GetSinkSlot().load(std::memory_order_acquire)->Write(records); }
+        void Flush() override { GetSinkSlot().load(std::memory_order_acquire)->Flush(); }
+        bool UsesColors() const override { return GetSinkSlot().load(std::memory_order_acquire)->UsesColors(); }
+    };
+
+    inline Sink& GetCurrentSink()
+    {
+        static CurrentSink sink;
+        GetSinkSlot();
+        return sink;
+    }
+}
+
+/// the sink must outlive every log call made while it is set
+inline void SetSink(Sink& sink) { detail::GetSinkSlot().store(&sink, std::memory_order_release); }
+inline Sink& GetSink() { return *detail::GetSinkSlot().load(std::memory_order_acquire); }
+
+//================================== sync backend
+
+namespace detail
+{
+    // the record is assembled in a thread local buffer and written with a single call,
+    // so lines of different threads don't interleave and the sink is entered once per record
+    template <typename... Args>
+    void WriteRecord(const char* color, const RecordInfo& info, const Args&... args)
+    {
+        Sink& sink = GetSink();
+        std::string& text = GetThreadText();
+        text.clear();
+
+        if constexpr (kRecordFormat != RecordFormat::kText)
+        {
+            std::string& message = GetThreadMessage();
+            message.clear();
+            AppendArgs(message, args...);
+            AppendStructuredRecord(text, kRecordFormat, info, message);
+            sink.Write(text);
+            return;
+        }
+
+        const bool colors = sink.UsesColors();
+        if (colors)
+            text.append(color);
+        text.append("[");
+        text.append(info.channel);
+        text.append("] ");
+        AppendArgs(text, args...);
+        if (colors)
+            text.append(kColorReset);
+        text.append("\n");
+
+        sink.Write(text);
+    }
+}
+
+//================================== async backend
+
+#ifdef NBKIT_LOG_ASYNC
+namespace detail
+{
+    inline AsyncWriter<NBKIT_LOG_ASYNC_QUEUE_SIZE>& GetAsyncWriter()
+    {
+        static AsyncWriter<NBKIT_LOG_ASYNC_QUEUE_SIZE> writer(GetCurrentSink(), kAsyncQueueFullPolicy, kRecordFormat);
+        return writer;
+    }
+}
+#endif
+
+//================================== binary backend
+
+#ifdef NBKIT_LOG_BINARY
+namespace detail
+{
+    inline constexpr auto kBinaryFlushInterval = std::chrono::milliseconds(10);
+
+    inline BinaryLogger& GetBinaryLogger()
+    {
+        static BinaryLogger& logger = []() -> BinaryLogger&
+        {
+            static BinaryLogger instance(NBKIT_LOG_BINARY_BUFFER_SIZE, kAsyncQueueFullPolicy);
+            instance.StartFlushThread(GetCurrentSink(), kBinaryFlushInterval);
+            return instance;
+        }();
+        return logger;
+    }
+
+    // static metadata is registered once per channel, level and argument types
+    template <Channel Ch, Level L, typename... Args>
+    uint32_t GetBinarySite()
+    {
+        static const uint32_t site = GetBinaryLogger().RegisterSite<Args...>(magic_enum::enum_name(Ch), GetLevelColor(L), kColorReset);
+        return site;
+    }
+
+    template <Level L, typename... Args>
+    uint32_t GetBinarySiteRuntime(Channel ch)
+    {
+        // 0 means not registered yet, otherwise site + 1
+        static std::array<std::atomic<uint32_t>, magic_enum::enum_count<Channel>()> sites {};
+
+        std::atomic<uint32_t>& slot = sites[*magic_enum::enum_index(ch)];
+        uint32_t site = slot.load(std::memory_order_acquire);
+        if (site == 0)
+        {
+            site = GetBinaryLogger().RegisterSite<Args...>(magic_enum::enum_name(ch), GetLevelColor(L), kColorReset) + 1;
+            slot.store(site, std::memory_order_release);
+        }
+        return site - 1;
+    }
+
+    // args that can't be captured raw are formatted on the caller thread and logged as a single string
+    template <typename... Args>
+    std::string_view FormatOnThread(const Args&... args)
+    {
+        std::string& text = GetThreadText();
+        text.clear();
+        AppendArgs(text, args...);
+        return text;
+    }
+
+    template <Channel Ch, Level L, typename... Args>
+    void LogBinary(const Args&... args)
+    {
+        if constexpr ((kIsBinaryEncodable<Args> && ...))
+            GetBinaryLogger().Log(GetBinarySite<Ch, L, Args...>(), args...);
+        else
+            GetBinaryLogger().Log(GetBinarySite<Ch, L, std::string_view>(), FormatOnThread(args...));
+    }
+
+    template <Level L, typename... Args>
+    void LogBinaryRuntime(Channel ch, const Args&... args)
+    {
+        if constexpr ((kIsBinaryEncodable<Args> && ...))
+            GetBinaryLogger().Log(GetBinarySiteRuntime<L, Args...>(ch), args...);
+        else
+            GetBinaryLogger().Log(GetBinarySiteRuntime<L, std::string_view>(ch), FormatOnThread(args...));
+    }
+}
+#endif
+
+//================================== runtime channel mask
+
+namespace detail
+{
+    inline constexpr size_t kChannelCount = magic_enum::enum_count<Channel>();
+    inline constexpr size_t kChannelMaskWords = (kChannelCount + 63) / 64;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "channel mask must be usable from signal handlers");
+
+    constexpr size_t GetChannelIndex(Channel channel) { return *magic_enum::enum_index(channel); }
+
+    constexpr std::array<uint64_t, kChannelMaskWords> GetCompileTimeChannelMask()
+    {
+        std::array<uint64_t, kChannelMaskWords> mask {};
+        for (const auto& channel : kEnabledChannels)
+            mask[GetChannelIndex(channel) / 64] |= uint64_t(1) << (GetChannelIndex(channel) % 64);
+        return mask;
+    }
+
+    template <size_t... I>
+    constexpr std::array<std::atomic<uint64_t>, kChannelMaskWords> MakeChannelMask(std::index_sequence<I...>)
+    {
+        return { std::atomic<uint64_t>(GetCompileTimeChannelMask()[I])... };
+    }
+
+    // bit enum_index(channel) is set while the channel is enabled, constant initialized so it's safe to touch from signal handlers
+    inline constinit std::array<std::atomic<uint64_t>, kChannelMaskWords> channel_mask =
+        MakeChannelMask(std::make_index_sequence<kChannelMaskWords>());
+
+    inline bool IsChannelBitSet(size_t index)
+    {
+        return (channel_mask[index / 64].load(std::memory_order_relaxed) >> (index % 64)) & 1;
+    }
+}
+
+//================================== sampling and rate limiting state
+
+namespace detail
+{
+    // xorshift64*, one generator per thread so sampling never contends
+    inline uint64_t NextRandom()
+    {
+        thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&state);
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    inline bool SampleRandom(double rate)
+    {
+        if (rate >= 1.0)
+            return true;
+        if (rate <= 0.0)
+            return false;
+        return static_cast<double>(NextRandom() >> 11) * 0x1.0p-53 < rate;
+    }
+
+    /// <summary>
+    /// Token bucket allowing per_second records per second with bursts of up to max(1, per_second),
+    /// kept as a single theoretical arrival time (GCRA) so acquiring is one CAS.
+    /// </summary>
+    class TokenBucket
+    {
+    private:
+        std::atomic<int64_t> arrival_ns_ { 0 };
+
+    public:
+        bool TryAcquire(double per_second)
+        {
+            if (per_second <= 0.0)
+                return false;
+
+            const auto interval_ns = static_cast<int64_t>(1e9 / per_second);
+            const int64_t tolerance_ns = std::max<int64_t>(interval_ns, 1'000'000'000) - interval_ns;
+            const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+            int64_t arrival_ns = arrival_ns_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const int64_t start_ns = std::max(arrival_ns, now_ns);
+                if (start_ns - now_ns > tolerance_ns)
+                    return false;
+                if (arrival_ns_.compare_exchange_weak(arrival_ns, start_ns + interval_ns, std::memory_order_relaxed))
+                    return true;
+            }
+        }
+    };
+
+    /// <summary>
+    /// Number of calls a rate limited call site suppressed since its last summary. Counters link themselves into one
+    /// global list when constructed and are never unlinked, so Flush() can report the counts of call sites that
+    /// stopped logging, which no later record of theirs would.
+    /// </summary>
+    class SuppressedCounter
+    {
+    public:
+        using Reporter = void (*)(uint64_t count);
+
+    private:
+        static inline constinit std::atomic<SuppressedCounter*> head_ { nullptr };
+
+        std::atomic<uint64_t> count_ { 0 };
+        Reporter report_;
+        SuppressedCounter* next_;
+
+    public:
+        explicit SuppressedCounter(Reporter report)
+            : report_(report), next_(head_.load(std::memory_order_relaxed))
+        {
+            while (!head_.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void Add() { count_.fetch_add(1, std::memory_order_relaxed); }
+
+        /// writes the pending count if there is one, each suppressed call is reported once
+        void Report()
+        {
+            if (count_.load(std::memory_order_relaxed) == 0)
+                return;
+
+            const uint64_t count = count_.exchange(0, std::memory_order_relaxed);
+            if (count > 0)
+                report_(count);
+        }
+
+        static void ReportAll()
+        {
+            for (SuppressedCounter* counter = head_.load(std::memory_order_acquire); counter != nullptr; counter = counter->next_)
+                counter->Report();
+        }
+    };
+}
+
 //================================== forward decl
 
 constexpr bool IsChannelEnabled(Channel channel);
+constexpr bool IsLevelEnabled(Level level);
+
+template <Channel Ch, Level L>
+constexpr bool IsEnabled();
 
 //================================== private namespace
 namespace
 {
-    template <Channel Ch, typename... Args>
-    void BaseLog(std::string_view color, Args... args)
+    // args callable without parameters are lazy: they are only invoked if the record is going to be written
+    template <typename T>
+    decltype(auto) ResolveArg(const T& arg)
     {
-        if constexpr (IsChannelEnabled(Ch) == false)
-            return;
+        if constexpr (std::is_invocable_v<const T&>)
+            return arg();
+        else
+            return (arg);
+    }
 
-        std::cout << color << "[" << magic_enum::enum_name(Ch) << "] ";
-        (std::cout << ... << args);
-        std::cout << detail::kColorReset << "\n";
+    // binary records are always decoded as text, so they ignore the call site
+    template <Channel Ch, Level L, typename... Args>
+    void DispatchAt([[maybe_unused]] const CallSite& site, const Args&... args)
+    {
+#if defined(NBKIT_LOG_BINARY)
+        detail::LogBinary<Ch, L>(args...);
+#elif defined(NBKIT_LOG_ASYNC)
+        detail::GetAsyncWriter().Push(detail::GetLevelColor(L), detail::kColorReset, detail::MakeRecordInfo<L>(magic_enum::enum_name(Ch), site), args...);
+#else
+        detail::WriteRecord(detail::GetLevelColor(L), detail::MakeRecordInfo<L>(magic_enum::enum_name(Ch), site), args...);
+#endif
     }
 
-    template <typename... Args>
-    void BaseLogRuntime(Channel ch, std::string_view color, Args... args)
+    template <Channel Ch, Level L, typename... Args>
+    void Dispatch(const Args&... args)
     {
-        if (!IsChannelEnabled(ch))
-            return;
+        DispatchAt<Ch, L>(CallSite {}, args...);
+    }
+
+    template <Level L, typename... Args>
+    void DispatchRuntime(Channel ch, const Args&... args)
+    {
+#if defined(NBKIT_LOG_BINARY)
+        detail::LogBinaryRuntime<L>(ch, args...);
+#elif defined(NBKIT_LOG_ASYNC)
+        detail::GetAsyncWriter().Push(detail::GetLevelColor(L), detail::kColorReset, detail::MakeRecordInfo<L>(magic_enum::enum_name(ch), {}), args...);
+#else
+        detail::WriteRecord(detail::GetLevelColor(L), detail::MakeRecordInfo<L>(magic_enum::enum_name(ch), {}), args...);
+#endif
+    }
+
+    template <Channel Ch, Level L, typename... Args>
+    void BaseLog(Args... args)
+    {
+        if constexpr (IsEnabled<Ch, L>())
+        {
+            if (detail::IsChannelBitSet(detail::GetChannelIndex(Ch)))
+                Dispatch<Ch, L>(ResolveArg(args)...);
+        }
+    }
+
+    template <Channel Ch, Level L, typename... Args>
+    void BaseLogAt(const CallSite& site, Args... args)
+    {
+        if constexpr (IsEnabled<Ch, L>())
+        {
+            if (detail::IsChannelBitSet(detail::GetChannelIndex(Ch)))
+                DispatchAt<Ch, L>(site, ResolveArg(args)...);
+        }
+    }
+
+    template <Level L, typename... Args>
+    void BaseLogRuntime(Channel ch, Args... args)
+    {
+        if constexpr (IsLevelEnabled(L))
+        {
+            if (detail::IsChannelBitSet(detail::GetChannelIndex(ch)))
+                DispatchRuntime<L>(ch, ResolveArg(args)...);
+        }
+    }
+
+    template <Channel Ch, Level L, typename Condition, typename... Args>
+    constexpr void BaseAssert([[maybe_unused]] Condition& condition, [[maybe_unused]] Args... args)
+    {
+#ifndef NBKIT_LOG_DISABLE_ASSERTS
+        if constexpr (IsEnabled<Ch, L>())
+        {
+            if (!detail::IsChannelBitSet(detail::GetChannelIndex(Ch)))
+                return;
+
+            bool holds;
+            if constexpr (std::is_invocable_v<Condition&>)
+                holds = static_cast<bool>(condition());
+            else
+                holds = static_cast<bool>(condition);
+
+            if (!holds)
+                Dispatch<Ch, L>(ResolveArg(args)...);
+        }
+#endif
+    }
+
+    //------ rate limited and sampled logging, Site is a distinct lambda per call site so each one gets its own statics
+
+    template <Channel Ch, Level L>
+    void ReportSuppressed(uint64_t count)
+    {
+        Dispatch<Ch, L>(count, " messages suppressed");
+    }
+
+    template <Channel Ch, Level L, size_t N, auto Site, typename... Args>
+    void LogEvery(Args... args)
+    {
+        static_assert(N > 0, "N must be greater than zero");
 
-        std::cout << color << "[" << magic_enum::enum_name(ch) << "] ";
-        (std::cout << ... << args);
-        std::cout << detail::kColorReset << "\n";
+        if constexpr (IsEnabled<Ch, L>())
+        {
+            static std::atomic<uint64_t> calls { 0 };
+            static detail::SuppressedCounter suppressed { &ReportSuppressed<Ch, L> };
+
+            if (!detail::IsChannelBitSet(detail::GetChannelIndex(Ch)))
+                return;
+
+            if (calls.fetch_add(1, std::memory_order_relaxed) % N != 0)
+            {
+                suppressed.Add();
+                return;
+            }
+
+            suppressed.Report();
+            Dispatch<Ch, L>(ResolveArg(args)...);
+        }
+    }
+
+    template <Channel Ch, Level L, auto Site, typename... Args>
+    void LogSampled(double rate, Args... args)
+    {
+        if constexpr (IsEnabled<Ch, L>())
+        {
+            static detail::SuppressedCounter suppressed { &ReportSuppressed<Ch, L> };
+
+            if (!detail::IsChannelBitSet(detail::GetChannelIndex(Ch)))
+                return;
+
+            if (!detail::SampleRandom(rate))
+            {
+                suppressed.Add();
+                return;
+            }
+
+            suppressed.Report();
+            Dispatch<Ch, L>(ResolveArg(args)...);
+        }
+    }
+
+    template <Channel Ch, Level L, auto Site, typename... Args>
+    void LogRateLimited(double per_second, Args... args)
+    {
+        if constexpr (IsEnabled<Ch, L>())
+        {
+            static detail::TokenBucket bucket;
+            static detail::SuppressedCounter suppressed { &ReportSuppressed<Ch, L> };
+
+            if (!detail::IsChannelBitSet(detail::GetChannelIndex(Ch)))
+                return;
+
+            if (!bucket.TryAcquire(per_second))
+            {
+                suppressed.Add();
+                return;
+            }
+
+            suppressed.Report();
+            Dispatch<Ch, L>(ResolveArg(args)...);
+        }
     }
 }
 
@@ -76,51 +626,170 @@ constexpr bool IsChannelEnabled(Channel channel)
     return false;
 }
 
+//------ runtime channel toggling (async-signal-safe), only channels enabled at compile time can be turned on
+inline bool SetChannelEnabled(Channel channel, bool enabled)
+{
+    if (enabled && !IsChannelEnabled(channel))
+        return false;
+
+    const size_t index = detail::GetChannelIndex(channel);
+    const uint64_t bit = uint64_t(1) << (index % 64);
+    if (enabled)
+        detail::channel_mask[index / 64].fetch_or(bit, std::memory_order_relaxed);
+    else
+        detail::channel_mask[index / 64].fetch_and(~bit, std::memory_order_relaxed);
+    return true;
+}
+
+inline bool EnableChannel(Channel channel) { return SetChannelEnabled(channel, true); }
+inline bool DisableChannel(Channel channel) { return SetChannelEnabled(channel, false); }
+
+inline bool IsChannelEnabledRuntime(Channel channel) { return detail::IsChannelBitSet(detail::GetChannelIndex(channel)); }
+
+/// restores the channels enabled at compile time
+inline void ResetChannels()
+{
+    constexpr auto kMask = detail::GetCompileTimeChannelMask();
+    for (size_t i = 0; i < detail::kChannelMaskWords; ++i)
+        detail::channel_mask[i].store(kMask[i], std::memory_order_relaxed);
+}
+
+//------ is level enabled
+constexpr bool IsLevelEnabled(Level level) { return level >= kMinLevel; }
+
+template <Channel Ch, Level L>
+constexpr bool IsEnabled() { return IsChannelEnabled(Ch) && IsLevelEnabled(L); }
+
+//------ flush (reports pending suppressed counts, waits for the async and binary backends, then flushes the sink)
+inline void Flush()
+{
+    detail::SuppressedCounter::ReportAll();
+#if defined(NBKIT_LOG_BINARY)
+    detail::GetBinaryLogger().Consume(detail::GetCurrentSink());
+#elif defined(NBKIT_LOG_ASYNC)
+    detail::GetAsyncWriter().Flush();
+#endif
+    GetSink().Flush();
+}
+
+inline uint64_t GetDroppedCount()
+{
+#if defined(NBKIT_LOG_BINARY)
+    return detail::GetBinaryLogger().GetDroppedCount();
+#elif defined(NBKIT_LOG_ASYNC)
+    return detail::GetAsyncWriter().GetDroppedCount();
+#else
+    return 0;
+#endif
+}
+
 //------ base logging
 template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void Verbose(Args... args) { BaseLog<Ch>(detail::kColorVerbose, args...); }
+constexpr void Verbose(Args... args) { BaseLog<Ch, Level::kVerbose>(args...); }
 
 template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void Info(Args... args) { BaseLog<Ch>(detail::kColorInfo, args...); }
+constexpr void Info(Args... args) { BaseLog<Ch, Level::kInfo>(args...); }
 
 template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void Sparkle(Args... args) { BaseLog<Ch>(detail::kColorSparkle, args...); }
+constexpr void Sparkle(Args... args) { BaseLog<Ch, Level::kSparkle>(args...); }
 
 template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void Warning(Args... args) { BaseLog<Ch>(detail::kColorWarning, args...); }
+constexpr void Warning(Args... args) { BaseLog<Ch, Level::kWarning>(args...); }
 
 template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void Error(Args... args) { BaseLog<Ch>(detail::kColorError, args...); }
+constexpr void Error(Args... args) { BaseLog<Ch, Level::kError>(args...); }
 
 //------ runtime logging (in some cases you dont know the channel at compiletime)
 template <typename... Args>
-void VerboseRuntime(Channel ch, Args... args) { BaseLogRuntime(ch, detail::kColorVerbose, args...); }
+void VerboseRuntime(Channel ch, Args... args) { BaseLogRuntime<Level::kVerbose>(ch, args...); }
 
 template <typename... Args>
-void InfoRuntime(Channel ch, Args... args) { BaseLogRuntime(ch, detail::kColorInfo, args...); }
+void InfoRuntime(Channel ch, Args... args) { BaseLogRuntime<Level::kInfo>(ch, args...); }
 
 template <typename... Args>
-void SparkleRuntime(Channel ch, Args... args) { BaseLogRuntime(ch, detail::kColorSparkle, args...); }
+void SparkleRuntime(Channel ch, Args... args) { BaseLogRuntime<Level::kSparkle>(ch, args...); }
 
 template <typename... Args>
-void WarningRuntime(Channel ch, Args... args) { BaseLogRuntime(ch, detail::kColorWarning, args...); }
+void WarningRuntime(Channel ch, Args... args) { BaseLogRuntime<Level::kWarning>(ch, args...); }
 
 template <typename... Args>
-void ErrorRuntime(Channel ch, Args... args) { BaseLogRuntime(ch, detail::kColorError, args...); }
+void ErrorRuntime(Channel ch, Args... args) { BaseLogRuntime<Level::kError>(ch, args...); }
 
-//------ asserts
-template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void AssertWarning(std::function<bool()> condition, Args... args)
+//------ rate limited and sampled logging (state is kept per call site, suppressed calls are reported by the next record or Flush())
+// XxxEvery<N> logs the 1st, N+1th, 2N+1th... call, XxxSampled logs each call with probability rate,
+// XxxRateLimited logs at most per_second records per second with bursts of up to per_second records
+template <size_t N, Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void VerboseEvery(Args... args) { LogEvery<Ch, Level::kVerbose, N, Site>(args...); }
+
+template <size_t N, Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void InfoEvery(Args... args) { LogEvery<Ch, Level::kInfo, N, Site>(args...); }
+
+template <size_t N, Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void SparkleEvery(Args... args) { LogEvery<Ch, Level::kSparkle, N, Site>(args...); }
+
+template <size_t N, Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void WarningEvery(Args... args) { LogEvery<Ch, Level::kWarning, N, Site>(args...); }
+
+template <size_t N, Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void ErrorEvery(Args... args) { LogEvery<Ch, Level::kError, N, Site>(args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void VerboseSampled(double rate, Args... args) { LogSampled<Ch, Level::kVerbose, Site>(rate, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void InfoSampled(double rate, Args... args) { LogSampled<Ch, Level::kInfo, Site>(rate, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void SparkleSampled(double rate, Args... args) { LogSampled<Ch, Level::kSparkle, Site>(rate, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void WarningSampled(double rate, Args... args) { LogSampled<Ch, Level::kWarning, Site>(rate, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void ErrorSampled(double rate, Args... args) { LogSampled<Ch, Level::kError, Site>(rate, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void VerboseRateLimited(double per_second, Args... args) { LogRateLimited<Ch, Level::kVerbose, Site>(per_second, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void InfoRateLimited(double per_second, Args... args) { LogRateLimited<Ch, Level::kInfo, Site>(per_second, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void SparkleRateLimited(double per_second, Args... args) { LogRateLimited<Ch, Level::kSparkle, Site>(per_second, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void WarningRateLimited(double per_second, Args... args) { LogRateLimited<Ch, Level::kWarning, Site>(per_second, args...); }
+
+template <Channel Ch = Channel::kDefault, auto Site = [] {}, typename... Args>
+void ErrorRateLimited(double per_second, Args... args) { LogRateLimited<Ch, Level::kError, Site>(per_second, args...); }
+
+//------ asserts (condition is a bool or any callable returning bool, callables are only invoked when the assert is enabled)
+//       asserts compile to nothing when the channel or level is disabled, or when NBKIT_LOG_DISABLE_ASSERTS is defined
+template <Channel Ch = Channel::kDefault, typename Condition, typename... Args>
+constexpr void AssertWarning(Condition&& condition, Args... args)
 {
-    if (!condition())
-        BaseLog<Ch>(detail::kColorWarning, args...);
+    BaseAssert<Ch, Level::kWarning>(condition, args...);
 }
 
-template <Channel Ch = Channel::kDefault, typename... Args>
-constexpr void AssertError(std::function<bool()> condition, Args... args)
+template <Channel Ch = Channel::kDefault, typename Condition, typename... Args>
+constexpr void AssertError(Condition&& condition, Args... args)
 {
-    if (!condition())
-        BaseLog<Ch>(detail::kColorError, args...);
+    BaseAssert<Ch, Level::kError>(condition, args...);
+}
+
 }
 
-}
\ No newline at end of file
+//================================== lazy macros
+// when the level or channel is disabled at compile time the arguments are not evaluated and no code is emitted,
+// Ch must be a full channel name, e.g. NBKIT_LOG_INFO(nbkit::log::Channel::kDefault, "value: ", Compute())
+// structured records written through the macros also carry file and line
+
+#define NBKIT_LOG_IMPL(L, Ch, ...) \
+    do { if constexpr (::nbkit::log::IsEnabled<Ch, L>()) \
+        ::nbkit::log::BaseLogAt<Ch, L>(::nbkit::log::CallSite { __FILE__, __LINE__ }, __VA_ARGS__); } while (false)
+
+#define NBKIT_LOG_VERBOSE(Ch, ...) NBKIT_LOG_IMPL(::nbkit::log::Level::kVerbose, Ch, __VA_ARGS__)
+#define NBKIT_LOG_INFO(Ch, ...)    NBKIT_LOG_IMPL(::nbkit::log::Level::kInfo,    Ch, __VA_ARGS__)
+#define NBKIT_LOG_SPARKLE(Ch, ...) NBKIT_LOG_IMPL(::nbkit::log::Level::kSparkle, Ch, __VA_ARGS__)
+#define NBKIT_LOG_WARNING(Ch, ...) NBKIT_LOG_IMPL(::nbkit::log::Level::kWarning, Ch, __VA_ARGS__)
+#define NBKIT_LOG_ERROR(Ch, ...)   NBKIT_LOG_IMPL(::nbkit::log::Level::kError,   Ch, __VA_ARGS__)
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "nbkit/log_format.h"
+#include "nbkit/log_sinks.h"
+#include "nbkit/log_stream.h"
+#include "nbkit/mpsc_ring_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace nbkit::log
+{
+    enum class QueueFullPolicy { kBlock, kDrop };
+
+    /// <summary>
+    /// Async log backend: callers format their arguments into a fixed size record and push it in a lock-free queue,
+    /// a dedicated thread decorates the records and writes them in batches, so callers never wait on the output.
+    /// Messages longer than kMaxTextSize are truncated. With a structured RecordFormat records are written as JSON or logfmt lines.
+    /// </summary>
+    template <size_t Capacity>
+    class AsyncWriter
+    {
+        // -------------------------------------------------------------------- fields
+    public:
+        static constexpr size_t kMaxTextSize = 224;
+
+        struct Record
+        {
+            const char* color = "";
+            const char* color_reset = "";
+            RecordInfo info;
+            uint16_t size = 0;
+            char text[kMaxTextSize];
+        };
+
+    private:
+        static constexpr size_t kMaxBatchRecords = 256;
+        static constexpr auto kIdleSleep = std::chrono::microseconds(200);
+
+        Sink& sink_;
+        QueueFullPolicy policy_;
+        RecordFormat format_;
+        MpscRingBuffer<Record, Capacity> queue_;
+
+        std::atomic<uint64_t> pushed_ { 0 };
+        std::atomic<uint64_t> written_ { 0 };
+        std::atomic<uint64_t> dropped_ { 0 };
+        std::atomic<bool> stop_ { false };
+        std::atomic<bool> finished_ { false };
+        std::thread thread_;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        AsyncWriter(Sink& sink, QueueFullPolicy policy, RecordFormat format = RecordFormat::kText)
+            : sink_(sink), policy_(policy), format_(format)
+        {
+            thread_ = std::thread([this]() { Run(); });
+        }
+
+        ~AsyncWriter() { Shutdown(); }
+
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator = (const AsyncWriter&) = delete;
+
+        template <typename... Args>
+        void Push(const char* color, const char* color_reset, std::string_view channel, const Args&... args)
+        {
+            RecordInfo info;
+            info.channel = channel;
+            Push(color, color_reset, info, args...);
+        }
+
+        template <typename... Args>
+        void Push(const char* color, const char* color_reset, const RecordInfo& info, const Args&... args)
+        {
+            if (stop_.load(std::memory_order_relaxed))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            Record record;
+            record.color = color;
+            record.color_reset = color_reset;
+            record.info = info;
+
+            detail::FixedStream& fixed_stream = detail::GetThreadFixedStream();
+            fixed_stream.buffer.Reset(record.text, kMaxTextSize);
+            fixed_stream.stream.clear();
+            (fixed_stream.stream << ... << args);
+            record.size = static_cast<uint16_t>(fixed_stream.buffer.GetSize());
+
+            while (!queue_.TryPush(record))
+            {
+                if (policy_ == QueueFullPolicy::kDrop)
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::yield();
+            }
+
+            pushed_.fetch_add(1, std::memory_order_release);
+        }
+
+        /// blocks until every record pushed before this call has been written
+        void Flush()
+        {
+            const uint64_t target = pushed_.load(std::memory_order_acquire);
+            while (written_.load(std::memory_order_acquire) < target && !finished_.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+
+        /// drains the queue and stops the writer thread, records pushed afterwards are dropped
+        void Shutdown()
+        {
+            if (!thread_.joinable())
+                return;
+
+            stop_.store(true, std::memory_order_release);
+            thread_.join();
+        }
+
+        uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        void Run()
+        {
+            std::string batch;
+            Record record;
+
+            for (;;)
+            {
+                const bool colors = sink_.UsesColors();
+                size_t count = 0;
+                while (count < kMaxBatchRecords && queue_.TryPop(record))
+                {
+                    ++count;
+                    if (format_ != RecordFormat::kText)
+                    {
+                        detail::AppendStructuredRecord(batch, format_, record.info, std::string_view(record.text, record.size));
+                        continue;
+                    }
+
+                    if (colors)
+                        batch.append(record.color);
+                    batch.append("[");
+                    batch.append(record.info.channel);
+                    batch.append("] ");
+                    batch.append(record.text, record.size);
+                    if (colors)
+                        batch.append(record.color_reset);
+                    batch.append("\n");
+                }
+
+                if (count > 0)
+                {
+                    sink_.Write(batch);
+                    sink_.Flush();
+                    batch.clear();
+                    written_.fetch_add(count, std::memory_order_release);
+                    continue;
+                }
+
+                if (stop_.load(std::memory_order_acquire))
+                    break;
+
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+
+            finished_.store(true, std::memory_order_release);
+        }
+    };
+}
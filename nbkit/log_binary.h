@@ -0,0 +1,631 @@
+#pragma once
+
+#include "nbkit/log_async.h"
+#include "nbkit/log_sinks.h"
+#include "nbkit/log_stream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nbkit::log
+{
+    namespace detail
+    {
+        enum class BinaryArgType : uint8_t
+        {
+            kBool, kChar,
+            kInt16, kInt32, kInt64,
+            kUInt16, kUInt32, kUInt64,
+            kFloat, kDouble, kLongDouble,
+            kPointer, kString,
+            kInvalid
+        };
+
+        template <typename T>
+        constexpr BinaryArgType GetBinaryArgType()
+        {
+            using U = std::decay_t<T>;
+
+            if constexpr (std::is_same_v<U, bool>)
+                return BinaryArgType::kBool;
+            else if constexpr (std::is_same_v<U, char> || std::is_same_v<U, signed char> || std::is_same_v<U, unsigned char>)
+                return BinaryArgType::kChar;
+            else if constexpr (std::is_same_v<U, wchar_t> || std::is_same_v<U, char8_t> || std::is_same_v<U, char16_t> || std::is_same_v<U, char32_t>)
+                return BinaryArgType::kInvalid;
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+                return sizeof(U) == 2 ? BinaryArgType::kInt16 : sizeof(U) == 4 ? BinaryArgType::kInt32 : BinaryArgType::kInt64;
+            else if constexpr (std::is_integral_v<U>)
+                return sizeof(U) == 2 ? BinaryArgType::kUInt16 : sizeof(U) == 4 ? BinaryArgType::kUInt32 : BinaryArgType::kUInt64;
+            else if constexpr (std::is_same_v<U, float>)
+                return BinaryArgType::kFloat;
+            else if constexpr (std::is_same_v<U, double>)
+                return BinaryArgType::kDouble;
+            else if constexpr (std::is_same_v<U, long double>)
+                return BinaryArgType::kLongDouble;
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>
+                               || std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+                return BinaryArgType::kString;
+            else if constexpr (std::is_pointer_v<U> && !std::is_function_v<std::remove_pointer_t<U>>
+                               && !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, char8_t>)
+                return BinaryArgType::kPointer;
+            else
+                return BinaryArgType::kInvalid;
+        }
+
+        /// types that can be captured raw and decoded later with the same output as streaming them right away
+        template <typename T>
+        inline constexpr bool kIsBinaryEncodable = GetBinaryArgType<T>() != BinaryArgType::kInvalid;
+
+        inline size_t GetBinaryArgSize(BinaryArgType type)
+        {
+            switch (type)
+            {
+                case BinaryArgType::kBool:
+                case BinaryArgType::kChar:       return 1;
+                case BinaryArgType::kInt16:
+                case BinaryArgType::kUInt16:     return 2;
+                case BinaryArgType::kInt32:
+                case BinaryArgType::kUInt32:
+                case BinaryArgType::kFloat:      return 4;
+                case BinaryArgType::kInt64:
+                case BinaryArgType::kUInt64:
+                case BinaryArgType::kDouble:
+                case BinaryArgType::kPointer:    return 8;
+                case BinaryArgType::kLongDouble: return sizeof(long double);
+                default:                         return 0;
+            }
+        }
+
+        template <typename T>
+        std::string_view GetBinaryString(const T& arg)
+        {
+            if constexpr (std::is_pointer_v<T>)
+                return arg == nullptr ? std::string_view() : std::string_view(arg);
+            else
+                return std::string_view(arg);
+        }
+
+        template <typename T>
+        size_t GetEncodedSize(const T& arg)
+        {
+            constexpr BinaryArgType kType = GetBinaryArgType<T>();
+            if constexpr (kType == BinaryArgType::kString)
+                return sizeof(uint32_t) + GetBinaryString(arg).size();
+            else
+                return GetBinaryArgSize(kType);
+        }
+
+        template <typename Value>
+        void WriteRaw(std::byte*& out, const Value& value)
+        {
+            std::memcpy(out, &value, sizeof(Value));
+            out += sizeof(Value);
+        }
+
+        template <typename Value>
+        Value ReadRaw(const std::byte*& in)
+        {
+            Value value;
+            std::memcpy(&value, in, sizeof(Value));
+            in += sizeof(Value);
+            return value;
+        }
+
+        template <typename T>
+        void EncodeArg(std::byte*& out, const T& arg)
+        {
+            constexpr BinaryArgType kType = GetBinaryArgType<T>();
+
+            if constexpr (kType == BinaryArgType::kBool || kType == BinaryArgType::kChar)
+                WriteRaw(out, static_cast<uint8_t>(arg));
+            else if constexpr (kType == BinaryArgType::kInt16 || kType == BinaryArgType::kInt32 || kType == BinaryArgType::kInt64)
+                WriteRaw(out, static_cast<std::make_signed_t<T>>(arg));
+            else if constexpr (kType == BinaryArgType::kUInt16 || kType == BinaryArgType::kUInt32 || kType == BinaryArgType::kUInt64)
+                WriteRaw(out, static_cast<std::make_unsigned_t<T>>(arg));
+            else if constexpr (kType == BinaryArgType::kPointer)
+                WriteRaw(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(arg)));
+            else if constexpr (kType == BinaryArgType::kString)
+            {
+                const std::string_view str = GetBinaryString(arg);
+                WriteRaw(out, static_cast<uint32_t>(str.size()));
+                std::memcpy(out, str.data(), str.size());
+                out += str.size();
+            }
+            else
+                WriteRaw(out, arg);
+        }
+
+        /// static metadata of a log site, shared by every record it produces
+        struct BinarySite
+        {
+            std::string channel;
+            std::string color;
+            std::string color_reset;
+            std::vector<BinaryArgType> arg_types;
+        };
+
+        /// appends the decoded record to text, returns false if payload does not match the site
+        inline bool DecodeBinaryRecord(const BinarySite& site, const std::byte* payload, size_t size, bool colors, std::string& text)
+        {
+            const std::byte* in = payload;
+            const std::byte* end = payload + size;
+
+            if (colors)
+                text.append(site.color);
+            text.append("[");
+            text.append(site.channel);
+            text.append("] ");
+
+            for (BinaryArgType type : site.arg_types)
+            {
+                const size_t arg_size = type == BinaryArgType::kString ? sizeof(uint32_t) : GetBinaryArgSize(type);
+                if (arg_size == 0 || static_cast<size_t>(end - in) < arg_size)
+                    return false;
+
+                switch (type)
+                {
+                    case BinaryArgType::kBool:       AppendArgs(text, ReadRaw<uint8_t>(in) != 0); break;
+                    case BinaryArgType::kChar:       text.push_back(static_cast<char>(ReadRaw<uint8_t>(in))); break;
+                    case BinaryArgType::kInt16:      AppendArgs(text, ReadRaw<int16_t>(in)); break;
+                    case BinaryArgType::kInt32:      AppendArgs(text, ReadRaw<int32_t>(in)); break;
+                    case BinaryArgType::kInt64:      AppendArgs(text, ReadRaw<int64_t>(in)); break;
+                    case BinaryArgType::kUInt16:     AppendArgs(text, ReadRaw<uint16_t>(in)); break;
+                    case BinaryArgType::kUInt32:     AppendArgs(text, ReadRaw<uint32_t>(in)); break;
+                    case BinaryArgType::kUInt64:     AppendArgs(text, ReadRaw<uint64_t>(in)); break;
+                    case BinaryArgType::kFloat:      AppendArgs(text, ReadRaw<float>(in)); break;
+                    case BinaryArgType::kDouble:     AppendArgs(text, ReadRaw<double>(in)); break;
+                    case BinaryArgType::kLongDouble: AppendArgs(text, ReadRaw<long double>(in)); break;
+                    case BinaryArgType::kPointer:
+                        AppendArgs(text, reinterpret_cast<const void*>(static_cast<uintptr_t>(ReadRaw<uint64_t>(in))));
+                        break;
+                    case BinaryArgType::kString:
+                    {
+                        const auto length = ReadRaw<uint32_t>(in);
+                        if (static_cast<size_t>(end - in) < length)
+                            return false;
+                        text.append(reinterpret_cast<const char*>(in), length);
+                        in += length;
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+
+            if (colors)
+                text.append(site.color_reset);
+            text.append("\n");
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Binary log backend: each call stores its site ID and raw argument bytes in a per-thread buffer,
+    /// text is only produced when the buffers are consumed (Consume, the flush thread, or DecodeRaw on a ConsumeRaw dump).
+    /// Records of the same thread keep their order, records of different threads are grouped by thread.
+    /// Raw dumps use the native byte order.
+    /// </summary>
+    class BinaryLogger
+    {
+        // -------------------------------------------------------------------- fields
+    public:
+        static constexpr size_t kDefaultThreadBufferSize = 64 * 1024;
+
+    private:
+        static constexpr size_t kRecordHeaderSize = 2 * sizeof(uint32_t);
+        static constexpr char kRawSiteTag = 'S';
+        static constexpr char kRawRecordTag = 'R';
+
+        /// single producer single consumer byte ring, written by its owner thread only
+        struct ThreadBuffer
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t capacity;
+            alignas(64) std::atomic<size_t> head { 0 };
+            alignas(64) std::atomic<size_t> tail { 0 };
+            std::atomic<bool> orphaned { false };
+
+            explicit ThreadBuffer(size_t size) : data(new std::byte[size]), capacity(size) {}
+
+            bool TryWrite(const std::byte* src, size_t size)
+            {
+                const size_t write_pos = head.load(std::memory_order_relaxed);
+                if (capacity - (write_pos - tail.load(std::memory_order_acquire)) < size)
+                    return false;
+
+                Copy(write_pos, src, size);
+                head.store(write_pos + size, std::memory_order_release);
+                return true;
+            }
+
+            void Copy(size_t pos, const std::byte* src, size_t size)
+            {
+                const size_t offset = pos & (capacity - 1);
+                const size_t first = std::min(size, capacity - offset);
+                std::memcpy(data.get() + offset, src, first);
+                std::memcpy(data.get(), src + first, size - first);
+            }
+
+            void Read(size_t pos, std::byte* dst, size_t size) const
+            {
+                const size_t offset = pos & (capacity - 1);
+                const size_t first = std::min(size, capacity - offset);
+                std::memcpy(dst, data.get() + offset, first);
+                std::memcpy(dst + first, data.get(), size - first);
+            }
+        };
+
+        struct ThreadCache
+        {
+            struct Entry
+            {
+                uint64_t logger_id;
+                std::shared_ptr<ThreadBuffer> buffer;
+            };
+            std::vector<Entry> entries;
+
+            ~ThreadCache()
+            {
+                for (auto& entry : entries)
+                    entry.buffer->orphaned.store(true, std::memory_order_release);
+            }
+        };
+
+        const uint64_t id_;
+        const size_t thread_buffer_size_;
+        const QueueFullPolicy policy_;
+
+        std::mutex sites_mutex_;
+        std::vector<std::unique_ptr<detail::BinarySite>> sites_;
+
+        std::mutex buffers_mutex_;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+        // consumer side, guarded by consume_mutex_
+        std::mutex consume_mutex_;
+        std::vector<const detail::BinarySite*> site_cache_;
+        std::vector<std::byte> payload_;
+        std::string text_;
+        size_t raw_emitted_sites_ = 0;
+
+        std::atomic<uint64_t> dropped_ { 0 };
+
+        std::mutex flush_mutex_;
+        std::condition_variable flush_cv_;
+        bool stop_flush_ = false;
+        std::atomic<bool> flush_thread_running_ { false };
+        std::thread flush_thread_;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        explicit BinaryLogger(size_t thread_buffer_size = kDefaultThreadBufferSize, QueueFullPolicy policy = QueueFullPolicy::kBlock)
+            : id_(NextLoggerId()), thread_buffer_size_(thread_buffer_size), policy_(policy)
+        {
+        }
+
+        ~BinaryLogger() { StopFlushThread(); }
+
+        BinaryLogger(const BinaryLogger&) = delete;
+        BinaryLogger& operator = (const BinaryLogger&) = delete;
+
+        /// registers the static metadata of a log site, call once per site and reuse the returned ID
+        template <typename... Args>
+        uint32_t RegisterSite(std::string_view channel, std::string_view color, std::string_view color_reset)
+        {
+            static_assert((detail::kIsBinaryEncodable<Args> && ...), "argument type can't be logged in binary");
+
+            auto site = std::make_unique<detail::BinarySite>();
+            site->channel = channel;
+            site->color = color;
+            site->color_reset = color_reset;
+            site->arg_types = { detail::GetBinaryArgType<Args>()... };
+
+            std::lock_guard lock(sites_mutex_);
+            sites_.push_back(std::move(site));
+            return static_cast<uint32_t>(sites_.size() - 1);
+        }
+
+        /// args must match the types the site was registered with
+        template <typename... Args>
+        void Log(uint32_t site, const Args&... args)
+        {
+            static_assert((detail::kIsBinaryEncodable<Args> && ...), "argument type can't be logged in binary");
+
+            const size_t payload_size = (size_t(0) + ... + detail::GetEncodedSize(args));
+            const size_t record_size = kRecordHeaderSize + payload_size;
+
+            ThreadBuffer& buffer = GetThreadBuffer();
+            if (record_size > buffer.capacity)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            thread_local std::vector<std::byte> scratch;
+            if (scratch.size() < record_size)
+                scratch.resize(record_size);
+
+            std::byte* out = scratch.data();
+            detail::WriteRaw(out, site);
+            detail::WriteRaw(out, static_cast<uint32_t>(payload_size));
+            (detail::EncodeArg(out, args), ...);
+
+            while (!buffer.TryWrite(scratch.data(), record_size))
+            {
+                if (policy_ == QueueFullPolicy::kDrop || !flush_thread_running_.load(std::memory_order_relaxed))
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        /// decodes every pending record and writes the text to sink
+        void Consume(Sink& sink)
+        {
+            std::lock_guard lock(consume_mutex_);
+
+            const bool colors = sink.UsesColors();
+            text_.clear();
+            for (const auto& buffer : SnapshotBuffers())
+            {
+                DrainBuffer(*buffer, [this, colors](uint32_t site_id)
+                {
+                    const detail::BinarySite* site = FindSite(site_id);
+                    if (site == nullptr || !detail::DecodeBinaryRecord(*site, payload_.data(), payload_.size(), colors, text_))
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+
+            if (!text_.empty())
+            {
+                sink.Write(text_);
+                sink.Flush();
+            }
+            RemoveOrphanedBuffers();
+        }
+
+        /// writes new site descriptions and every pending record undecoded, DecodeRaw turns the result into text
+        void ConsumeRaw(std::ostream& out)
+        {
+            std::lock_guard lock(consume_mutex_);
+
+            {
+                std::lock_guard sites_lock(sites_mutex_);
+                for (; raw_emitted_sites_ < sites_.size(); ++raw_emitted_sites_)
+                    WriteRawSite(out, static_cast<uint32_t>(raw_emitted_sites_), *sites_[raw_emitted_sites_]);
+            }
+
+            for (const auto& buffer : SnapshotBuffers())
+            {
+                DrainBuffer(*buffer, [this, &out](uint32_t site_id)
+                {
+                    const auto payload_size = static_cast<uint32_t>(payload_.size());
+                    out.put(kRawRecordTag);
+                    out.write(reinterpret_cast<const char*>(&site_id), sizeof(site_id));
+                    out.write(reinterpret_cast<const char*>(&payload_size), sizeof(payload_size));
+                    out.write(reinterpret_cast<const char*>(payload_.data()), payload_size);
+                });
+            }
+
+            out.flush();
+            RemoveOrphanedBuffers();
+        }
+
+        /// offline decoder for ConsumeRaw dumps, returns false if the dump is malformed
+        static bool DecodeRaw(std::istream& in, std::ostream& out, bool colors = false)
+        {
+            std::vector<detail::BinarySite> sites;
+            std::vector<std::byte> payload;
+            std::string text;
+
+            for (int tag = in.get(); tag != std::char_traits<char>::eof(); tag = in.get())
+            {
+                uint32_t id = 0;
+                if (!ReadValue(in, id))
+                    return false;
+
+                if (tag == kRawSiteTag)
+                {
+                    detail::BinarySite site;
+                    uint8_t arg_count = 0;
+                    if (!ReadString(in, site.channel) || !ReadString(in, site.color) || !ReadString(in, site.color_reset) || !ReadValue(in, arg_count))
+                        return false;
+
+                    site.arg_types.resize(arg_count);
+                    if (!in.read(reinterpret_cast<char*>(site.arg_types.data()), arg_count))
+                        return false;
+
+                    if (sites.size() <= id)
+                        sites.resize(id + 1);
+                    sites[id] = std::move(site);
+                }
+                else if (tag == kRawRecordTag)
+                {
+                    uint32_t size = 0;
+                    if (!ReadValue(in, size) || id >= sites.size())
+                        return false;
+
+                    payload.resize(size);
+                    if (!in.read(reinterpret_cast<char*>(payload.data()), size))
+                        return false;
+
+                    text.clear();
+                    if (!detail::DecodeBinaryRecord(sites[id], payload.data(), size, colors, text))
+                        return false;
+                    out << text;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// decodes pending records into sink every interval, until StopFlushThread or destruction
+        void StartFlushThread(Sink& sink, std::chrono::milliseconds interval)
+        {
+            StopFlushThread();
+
+            stop_flush_ = false;
+            flush_thread_running_.store(true, std::memory_order_relaxed);
+            flush_thread_ = std::thread([this, &sink, interval]()
+            {
+                std::unique_lock lock(flush_mutex_);
+                while (!stop_flush_)
+                {
+                    lock.unlock();
+                    Consume(sink);
+                    lock.lock();
+                    flush_cv_.wait_for(lock, interval, [this]() { return stop_flush_; });
+                }
+                lock.unlock();
+                Consume(sink);
+            });
+        }
+
+        void StopFlushThread()
+        {
+            if (!flush_thread_.joinable())
+                return;
+
+            {
+                std::lock_guard lock(flush_mutex_);
+                stop_flush_ = true;
+            }
+            flush_cv_.notify_all();
+            flush_thread_.join();
+            flush_thread_running_.store(false, std::memory_order_relaxed);
+        }
+
+        uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        static uint64_t NextLoggerId()
+        {
+            static std::atomic<uint64_t> next_id { 0 };
+            return next_id.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ThreadBuffer& GetThreadBuffer()
+        {
+            thread_local ThreadCache cache;
+
+            for (auto& entry : cache.entries)
+                if (entry.logger_id == id_)
+                    return *entry.buffer;
+
+            auto buffer = std::make_shared<ThreadBuffer>(std::bit_ceil(thread_buffer_size_));
+            {
+                std::lock_guard lock(buffers_mutex_);
+                buffers_.push_back(buffer);
+            }
+            cache.entries.push_back({ id_, buffer });
+            return *buffer;
+        }
+
+        std::vector<std::shared_ptr<ThreadBuffer>> SnapshotBuffers()
+        {
+            std::lock_guard lock(buffers_mutex_);
+            return buffers_;
+        }
+
+        void RemoveOrphanedBuffers()
+        {
+            std::lock_guard lock(buffers_mutex_);
+            std::erase_if(buffers_, [](const std::shared_ptr<ThreadBuffer>& buffer)
+            {
+                return buffer->orphaned.load(std::memory_order_acquire)
+                    && buffer->head.load(std::memory_order_acquire) == buffer->tail.load(std::memory_order_relaxed);
+            });
+        }
+
+        /// copies each complete record payload in payload_ and hands its site ID to on_record
+        template <typename OnRecord>
+        void DrainBuffer(ThreadBuffer& buffer, OnRecord&& on_record)
+        {
+            size_t read_pos = buffer.tail.load(std::memory_order_relaxed);
+            const size_t write_pos = buffer.head.load(std::memory_order_acquire);
+
+            while (write_pos - read_pos >= kRecordHeaderSize)
+            {
+                std::byte header[kRecordHeaderSize];
+                buffer.Read(read_pos, header, kRecordHeaderSize);
+
+                const std::byte* in = header;
+                const auto site_id = detail::ReadRaw<uint32_t>(in);
+                const auto payload_size = detail::ReadRaw<uint32_t>(in);
+
+                payload_.resize(payload_size);
+                buffer.Read(read_pos + kRecordHeaderSize, payload_.data(), payload_size);
+                read_pos += kRecordHeaderSize + payload_size;
+
+                on_record(site_id);
+            }
+
+            buffer.tail.store(read_pos, std::memory_order_release);
+        }
+
+        const detail::BinarySite* FindSite(uint32_t site_id)
+        {
+            if (site_id >= site_cache_.size())
+            {
+                std::lock_guard lock(sites_mutex_);
+                for (size_t i = site_cache_.size(); i < sites_.size(); ++i)
+                    site_cache_.push_back(sites_[i].get());
+            }
+            return site_id < site_cache_.size() ? site_cache_[site_id] : nullptr;
+        }
+
+        static void WriteRawSite(std::ostream& out, uint32_t id, const detail::BinarySite& site)
+        {
+            const auto write_string = [&out](const std::string& str)
+            {
+                const auto size = static_cast<uint32_t>(str.size());
+                out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                out.write(str.data(), size);
+            };
+
+            const auto arg_count = static_cast<uint8_t>(site.arg_types.size());
+            out.put(kRawSiteTag);
+            out.write(reinterpret_cast<const char*>(&id), sizeof(id));
+            write_string(site.channel);
+            write_string(site.color);
+            write_string(site.color_reset);
+            out.write(reinterpret_cast<const char*>(&arg_count), sizeof(arg_count));
+            out.write(reinterpret_cast<const char*>(site.arg_types.data()), arg_count);
+        }
+
+        template <typename Value>
+        static bool ReadValue(std::istream& in, Value& value)
+        {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(Value)));
+        }
+
+        static bool ReadString(std::istream& in, std::string& str)
+        {
+            uint32_t size = 0;
+            if (!ReadValue(in, size))
+                return false;
+            str.resize(size);
+            return static_cast<bool>(in.read(str.data(), size));
+        }
+    };
+}
@@ -5,6 +5,7 @@
 
 #pragma once
 #include <array>
+#include "nbkit/log_sinks.h"
 
 namespace nbkit::log
 {
@@ -38,6 +39,43 @@ namespace detail
     inline constexpr const char* kColorError   = "\x1b[0;38;2;255;0;0m";
 }
 
+//------ compile-time minimum severity, lower levels compile to nothing (uncomment to override)
+
+#define NBKIT_LOG_MIN_LEVEL NBKIT_LOG_LEVEL_INFO
+
+//------ compile out every AssertWarning / AssertError, conditions are not evaluated (uncomment to override)
+
+#define NBKIT_LOG_DISABLE_ASSERTS
+
+//------ override default sink, e.g. to log on a file without colors (uncomment block to override)
+//       the sink can also be swapped at runtime with nbkit::log::SetSink
+
+#define NBKIT_LOG_SINK_OVERRIDE
+inline Sink& GetDefaultSink()
+{
+    static FileSink sink("app.log");
+    return sink;
+}
+
+//------ structured output: one JSON object or logfmt line per record, without colors (uncomment one to enable)
+//       fields: monotonic timestamp (ns), level, channel, thread id, file and line (NBKIT_LOG_* macros only), message
+//       applies to the sync and async backends, binary records are still decoded as text
+
+#define NBKIT_LOG_FORMAT_JSON
+#define NBKIT_LOG_FORMAT_LOGFMT
+
+//------ async logging: records are written by a background thread (uncomment block to enable)
+
+#define NBKIT_LOG_ASYNC
+#define NBKIT_LOG_ASYNC_QUEUE_SIZE 4096         // power of two
+#define NBKIT_LOG_ASYNC_DROP_WHEN_FULL          // drop and count records instead of blocking when the queue is full
+
+//------ binary logging: args are stored raw in per-thread buffers and formatted by a flush thread (uncomment block to enable)
+//       takes precedence over NBKIT_LOG_ASYNC, NBKIT_LOG_ASYNC_DROP_WHEN_FULL applies to full thread buffers too
+
+#define NBKIT_LOG_BINARY
+#define NBKIT_LOG_BINARY_BUFFER_SIZE 65536      // bytes per thread
+
 }
 
 #endif
\ No newline at end of file
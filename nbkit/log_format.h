@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace nbkit::log
+{
+    /// kText is the human readable "[Channel] message" line, kJson one JSON object per line, kLogfmt key=value pairs
+    enum class RecordFormat { kText, kJson, kLogfmt };
+
+    /// source location of a log call, only known when logging through the NBKIT_LOG_* macros
+    struct CallSite
+    {
+        const char* file = nullptr;
+        uint32_t line = 0;
+    };
+
+    /// record fields besides the message, timestamp and thread are only filled when a structured format is used
+    struct RecordInfo
+    {
+        std::string_view level;
+        std::string_view channel;
+        uint64_t timestamp_ns = 0;
+        uint32_t thread_id = 0;
+        CallSite site;
+    };
+
+    namespace detail
+    {
+        /// steady clock nanoseconds, not related to wall clock time
+        inline uint64_t GetMonotonicNs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /// small sequential id given to each thread the first time it logs
+        inline uint32_t GetLogThreadId()
+        {
+            static std::atomic<uint32_t> next_id { 1 };
+            thread_local const uint32_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
+
+        inline void AppendNumber(std::string& out, uint64_t value)
+        {
+            char digits[20];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        inline void AppendControlEscape(std::string& out, char c)
+        {
+            constexpr const char* kHex = "0123456789abcdef";
+            const auto byte = static_cast<unsigned char>(c);
+            out.append("\\u00");
+            out.push_back(kHex[byte >> 4]);
+            out.push_back(kHex[byte & 0xF]);
+        }
+
+        /// appends value between quotes, escaping quotes, backslashes and control characters
+        inline void AppendQuoted(std::string& out, std::string_view value)
+        {
+            out.push_back('"');
+            for (const char c : value)
+            {
+                switch (c)
+                {
+                    case '"':  out.append("\\\""); break;
+                    case '\\': out.append("\\\\"); break;
+                    case '\n': out.append("\\n"); break;
+                    case '\r': out.append("\\r"); break;
+                    case '\t': out.append("\\t"); break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20)
+                            AppendControlEscape(out, c);
+                        else
+                            out.push_back(c);
+                }
+            }
+            out.push_back('"');
+        }
+
+        /// logfmt values are only quoted when they contain spaces, '=', quotes or control characters
+        inline void AppendLogfmtValue(std::string& out, std::string_view value)
+        {
+            bool needs_quotes = value.empty();
+            for (const char c : value)
+                needs_quotes |= c == ' ' || c == '=' || c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+
+            if (needs_quotes)
+                AppendQuoted(out, value);
+            else
+                out.append(value);
+        }
+
+        /// appends a full record terminated by a newline, only grows out when its capacity is not enough
+        inline void AppendStructuredRecord(std::string& out, RecordFormat format, const RecordInfo& info, std::string_view message)
+        {
+            if (format == RecordFormat::kJson)
+            {
+                out.append("{\"ts\":");
+                AppendNumber(out, info.timestamp_ns);
+                out.append(",\"level\":");
+                AppendQuoted(out, info.level);
+                out.append(",\"channel\":");
+                AppendQuoted(out, info.channel);
+                out.append(",\"thread\":");
+                AppendNumber(out, info.thread_id);
+                if (info.site.file != nullptr)
+                {
+                    out.append(",\"file\":");
+                    AppendQuoted(out, info.site.file);
+                    out.append(",\"line\":");
+                    AppendNumber(out, info.site.line);
+                }
+                out.append(",\"msg\":");
+                AppendQuoted(out, message);
+                out.append("}\n");
+            }
+            else
+            {
+                out.append("ts=");
+                AppendNumber(out, info.timestamp_ns);
+                out.append(" level=");
+                AppendLogfmtValue(out, info.level);
+                out.append(" channel=");
+                AppendLogfmtValue(out, info.channel);
+                out.append(" thread=");
+                AppendNumber(out, info.thread_id);
+                if (info.site.file != nullptr)
+                {
+                    out.append(" file=");
+                    AppendLogfmtValue(out, info.site.file);
+                    out.append(" line=");
+                    AppendNumber(out, info.site.line);
+                }
+                out.append(" msg=");
+                AppendQuoted(out, message);
+                out.append("\n");
+            }
+        }
+    }
+}
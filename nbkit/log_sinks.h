@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define NBKIT_LOG_HAS_MMAP_SINK
+#endif
+
+namespace nbkit::log
+{
+    /// <summary>
+    /// Destination of formatted log records. Write receives one or more complete lines and can be called
+    /// from several threads at once, so implementations must be thread safe.
+    /// </summary>
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+
+        virtual void Write(std::string_view records) = 0;
+        virtual void Flush() {}
+
+        /// when false records are formatted without ANSI color escapes
+        virtual bool UsesColors() const { return false; }
+    };
+
+    //================================== stream sinks
+
+    /// writes each call with a single std::ostream::write, thread safe if the stream is (like std::cout)
+    class OStreamSink : public Sink
+    {
+    private:
+        std::ostream& out_;
+        bool colors_;
+
+    public:
+        explicit OStreamSink(std::ostream& out, bool colors = true) : out_(out), colors_(colors) {}
+
+        void Write(std::string_view records) override { out_.write(records.data(), static_cast<std::streamsize>(records.size())); }
+        void Flush() override { out_.flush(); }
+        bool UsesColors() const override { return colors_; }
+    };
+
+    class StdoutSink : public OStreamSink
+    {
+    public:
+        StdoutSink() : OStreamSink(std::cout, true) {}
+    };
+
+    //================================== file sinks
+
+    namespace detail
+    {
+        /// file descriptor with a user space buffer, so the kernel sees few large write calls
+        class BufferedFile
+        {
+        private:
+            int fd_ = -1;
+            std::vector<char> buffer_;
+            size_t used_ = 0;
+            uint64_t size_ = 0;
+
+        public:
+            explicit BufferedFile(size_t buffer_size) : buffer_(buffer_size) {}
+            ~BufferedFile() { Close(); }
+
+            BufferedFile(const BufferedFile&) = delete;
+            BufferedFile& operator = (const BufferedFile&) = delete;
+
+            bool Open(const std::string& path, bool append)
+            {
+                Close();
+#ifdef _WIN32
+                const int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+                fd_ = _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+                const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+                fd_ = ::open(path.c_str(), flags, 0644);
+#endif
+                std::error_code error;
+                const auto file_size = std::filesystem::file_size(path, error);
+                size_ = error ? 0 : static_cast<uint64_t>(file_size);
+                return IsOpen();
+            }
+
+            void Close()
+            {
+                if (!IsOpen())
+                    return;
+
+                Flush();
+#ifdef _WIN32
+                _close(fd_);
+#else
+                ::close(fd_);
+#endif
+                fd_ = -1;
+            }
+
+            bool IsOpen() const { return fd_ >= 0; }
+
+            /// bytes in the file, including the ones still buffered
+            uint64_t GetSize() const { return size_; }
+
+            void Write(std::string_view data)
+            {
+                if (!IsOpen())
+                    return;
+
+                size_ += data.size();
+                if (used_ + data.size() > buffer_.size())
+                    Flush();
+
+                if (data.size() >= buffer_.size())
+                {
+                    WriteAll(data.data(), data.size());
+                    return;
+                }
+
+                std::memcpy(buffer_.data() + used_, data.data(), data.size());
+                used_ += data.size();
+            }
+
+            void Flush()
+            {
+                if (used_ == 0)
+                    return;
+
+                WriteAll(buffer_.data(), used_);
+                used_ = 0;
+            }
+
+        private:
+            void WriteAll(const char* data, size_t size)
+            {
+                while (size > 0)
+                {
+#ifdef _WIN32
+                    const int written = _write(fd_, data, static_cast<unsigned int>(std::min<size_t>(size, INT32_MAX)));
+#else
+                    const ssize_t written = ::write(fd_, data, size);
+#endif
+                    if (written <= 0)
+                        return;
+
+                    data += written;
+                    size -= static_cast<size_t>(written);
+                }
+            }
+        };
+    }
+
+    /// <summary>
+    /// Appends records to a file through a large buffer, records are written to disk when the buffer fills up or on Flush.
+    /// If the file can't be opened records are discarded.
+    /// </summary>
+    class FileSink : public Sink
+    {
+    public:
+        static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+    private:
+        std::mutex mutex_;
+        detail::BufferedFile file_;
+
+    public:
+        explicit FileSink(const std::string& path, bool append = true, size_t buffer_size = kDefaultBufferSize)
+            : file_(buffer_size)
+        {
+            file_.Open(path, append);
+        }
+
+        bool IsOpen() const { return file_.IsOpen(); }
+
+        void Write(std::string_view records) override
+        {
+            std::lock_guard lock(mutex_);
+            file_.Write(records);
+        }
+
+        void Flush() override
+        {
+            std::lock_guard lock(mutex_);
+            file_.Flush();
+        }
+    };
+
+    /// <summary>
+    /// File sink that starts a new file when the current one would exceed max_file_size.
+    /// Older files are renamed path.1 (most recent) ... path.max_backups, the oldest one is deleted.
+    /// </summary>
+    class RotatingFileSink : public Sink
+    {
+    private:
+        std::mutex mutex_;
+        detail::BufferedFile file_;
+        std::string path_;
+        uint64_t max_file_size_;
+        size_t max_backups_;
+
+    public:
+        RotatingFileSink(const std::string& path, uint64_t max_file_size, size_t max_backups,
+                         size_t buffer_size = FileSink::kDefaultBufferSize)
+            : file_(buffer_size), path_(path), max_file_size_(max_file_size), max_backups_(max_backups)
+        {
+            file_.Open(path_, true);
+        }
+
+        bool IsOpen() const { return file_.IsOpen(); }
+
+        void Write(std::string_view records) override
+        {
+            std::lock_guard lock(mutex_);
+
+            if (file_.GetSize() > 0 && file_.GetSize() + records.size() > max_file_size_)
+                Rotate();
+
+            file_.Write(records);
+        }
+
+        void Flush() override
+        {
+            std::lock_guard lock(mutex_);
+            file_.Flush();
+        }
+
+    private:
+        std::string GetBackupPath(size_t index) const { return path_ + "." + std::to_string(index); }
+
+        void Rotate()
+        {
+            file_.Close();
+
+            std::error_code error;
+            if (max_backups_ == 0)
+            {
+                std::filesystem::remove(path_, error);
+            }
+            else
+            {
+                std::filesystem::remove(GetBackupPath(max_backups_), error);
+                for (size_t i = max_backups_ - 1; i >= 1; --i)
+                    std::filesystem::rename(GetBackupPath(i), GetBackupPath(i + 1), error);
+                std::filesystem::rename(path_, GetBackupPath(1), error);
+            }
+
+            file_.Open(path_, false);
+        }
+    };
+
+    //================================== memory mapped ring sink
+
+#ifdef NBKIT_LOG_HAS_MMAP_SINK
+    /// <summary>
+    /// Writes records into a pre-allocated memory mapped file used as a ring buffer: callers only copy bytes,
+    /// the kernel writes pages back to disk on its own. When the ring is full the oldest bytes are overwritten.
+    /// Concurrent writers reserve disjoint ranges with an atomic offset, so Write never takes a lock.
+    /// Use ReadRing to get the content back in order.
+    /// </summary>
+    class MmapRingSink : public Sink
+    {
+    private:
+        static constexpr char kMagic[8] = { 'N', 'B', 'K', 'R', 'I', 'N', 'G', '1' };
+
+        struct Header
+        {
+            char magic[8];
+            uint64_t capacity;
+            std::atomic<uint64_t> write_pos;
+        };
+
+        static constexpr size_t kDataOffset = 64;
+        static_assert(sizeof(Header) <= kDataOffset);
+
+        int fd_ = -1;
+        void* mapping_ = nullptr;
+        size_t mapping_size_ = 0;
+        Header* header_ = nullptr;
+        char* data_ = nullptr;
+
+    public:
+        MmapRingSink(const std::string& path, size_t capacity)
+        {
+            if (capacity == 0)
+                return;
+
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+                return;
+
+            mapping_size_ = kDataOffset + capacity;
+            if (::ftruncate(fd_, static_cast<off_t>(mapping_size_)) != 0)
+                return;
+
+            void* mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (mapping == MAP_FAILED)
+                return;
+
+            mapping_ = mapping;
+            header_ = new (mapping_) Header { {}, capacity, { 0 } };
+            std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+            data_ = static_cast<char*>(mapping_) + kDataOffset;
+        }
+
+        ~MmapRingSink()
+        {
+            if (mapping_ != nullptr)
+            {
+                ::msync(mapping_, mapping_size_, MS_SYNC);
+                ::munmap(mapping_, mapping_size_);
+            }
+            if (fd_ >= 0)
+                ::close(fd_);
+        }
+
+        MmapRingSink(const MmapRingSink&) = delete;
+        MmapRingSink& operator = (const MmapRingSink&) = delete;
+
+        bool IsOpen() const { return header_ != nullptr; }
+
+        void Write(std::string_view records) override
+        {
+            if (!IsOpen() || records.empty())
+                return;
+
+            const uint64_t capacity = header_->capacity;
+            if (records.size() > capacity)
+                records.remove_prefix(records.size() - capacity);
+
+            const uint64_t pos = header_->write_pos.fetch_add(records.size(), std::memory_order_relaxed);
+            const size_t offset = static_cast<size_t>(pos % capacity);
+            const size_t first = std::min<size_t>(records.size(), capacity - offset);
+            std::memcpy(data_ + offset, records.data(), first);
+            std::memcpy(data_, records.data() + first, records.size() - first);
+        }
+
+        void Flush() override
+        {
+            if (IsOpen())
+                ::msync(mapping_, mapping_size_, MS_ASYNC);
+        }
+
+        /// returns the ring content of a file written by MmapRingSink, oldest byte first
+        static std::string ReadRing(const std::string& path)
+        {
+            std::string content;
+
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return content;
+
+            struct stat info {};
+            if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) > kDataOffset)
+            {
+                const auto size = static_cast<size_t>(info.st_size);
+                void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+                if (mapping != MAP_FAILED)
+                {
+                    const auto* header = static_cast<const Header*>(mapping);
+                    const char* data = static_cast<const char*>(mapping) + kDataOffset;
+                    const uint64_t capacity = header->capacity;
+                    const uint64_t write_pos = header->write_pos.load(std::memory_order_relaxed);
+
+                    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 && kDataOffset + capacity <= size)
+                    {
+                        if (write_pos <= capacity)
+                        {
+                            content.assign(data, static_cast<size_t>(write_pos));
+                        }
+                        else
+                        {
+                            const size_t offset = static_cast<size_t>(write_pos % capacity);
+                            content.assign(data + offset, static_cast<size_t>(capacity) - offset);
+                            content.append(data, offset);
+                        }
+                    }
+                    ::munmap(mapping, size);
+                }
+            }
+
+            ::close(fd);
+            return content;
+        }
+    };
+#endif
+}
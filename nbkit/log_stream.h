@@ -0,0 +1,90 @@
+#pragma once
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace nbkit::log::detail
+{
+    /// streambuf writing into a caller provided fixed size buffer, characters that don't fit are discarded
+    class FixedStreamBuf : public std::streambuf
+    {
+    public:
+        void Reset(char* begin, size_t size) { setp(begin, begin + size); }
+        size_t GetSize() const { return static_cast<size_t>(pptr() - pbase()); }
+
+    protected:
+        int_type overflow(int_type) override { return traits_type::eof(); }
+    };
+
+    /// streambuf appending to a std::string, keeping its capacity between records
+    class StringStreamBuf : public std::streambuf
+    {
+    private:
+        std::string* target_ = nullptr;
+
+    public:
+        void Reset(std::string& target) { target_ = &target; }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                target_->push_back(traits_type::to_char_type(ch));
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize count) override
+        {
+            target_->append(s, static_cast<size_t>(count));
+            return count;
+        }
+    };
+
+    struct FixedStream
+    {
+        FixedStreamBuf buffer;
+        std::ostream stream { &buffer };
+    };
+
+    struct StringStream
+    {
+        StringStreamBuf buffer;
+        std::ostream stream { &buffer };
+    };
+
+    inline FixedStream& GetThreadFixedStream()
+    {
+        thread_local FixedStream fixed_stream;
+        return fixed_stream;
+    }
+
+    inline StringStream& GetThreadStringStream()
+    {
+        thread_local StringStream string_stream;
+        return string_stream;
+    }
+
+    inline std::string& GetThreadText()
+    {
+        thread_local std::string text;
+        return text;
+    }
+
+    /// scratch for the message alone, used when the record around it needs escaping
+    inline std::string& GetThreadMessage()
+    {
+        thread_local std::string message;
+        return message;
+    }
+
+    /// formats args appending them to target, only allocates when target needs to grow
+    template <typename... Args>
+    void AppendArgs(std::string& target, const Args&... args)
+    {
+        StringStream& string_stream = GetThreadStringStream();
+        string_stream.buffer.Reset(target);
+        string_stream.stream.clear();
+        (string_stream.stream << ... << args);
+    }
+}
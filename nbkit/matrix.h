@@ -1,44 +1,424 @@
 #pragma once
 
+#include "nbkit/matrix_layout.h"
+#include "nbkit/matrix_view.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Define NBKIT_MATRIX_BOUNDS_CHECK (typically in debug builds) to make Matrix::Get, RowPtr and the views (Row, Col,
+// SubMatrix) check their coordinates and abort with the faulty access on stderr, instead of silently reaching another
+// row or past the storage.
+// Without it, the coordinates are assumed in range, which lets the compiler drop the checks of the storage.
+
+/// tells the optimizer cond holds, undefined behaviour if it doesn't; cond must have no side effects
+#if defined(__clang__)
+    #define NBKIT_ASSUME(cond) __builtin_assume(cond)
+#elif defined(__GNUC__)
+    #define NBKIT_ASSUME(cond) do { if (!(cond)) __builtin_unreachable(); } while (false)
+#elif defined(_MSC_VER)
+    #define NBKIT_ASSUME(cond) __assume(cond)
+#else
+    #define NBKIT_ASSUME(cond) ((void)0)
+#endif
+
 namespace nbkit
 {
+    namespace detail
+    {
+        [[noreturn]] inline void ReportOutOfBounds(const char* function, size_t x, size_t y, size_t width, size_t height)
+        {
+            std::fprintf(stderr, "nbkit::Matrix::%s(%zu, %zu) out of bounds of a %zu x %zu matrix\n", function, x, y, width, height);
+            std::abort();
+        }
+
+        [[noreturn]] inline void ReportRegionOutOfBounds(const char* function, size_t x, size_t y, size_t region_width, size_t region_height,
+                                                         size_t width, size_t height)
+        {
+            std::fprintf(stderr, "nbkit::Matrix::%s(%zu, %zu, %zu, %zu) out of bounds of a %zu x %zu matrix\n", function, x, y,
+                         region_width, region_height, width, height);
+            std::abort();
+        }
+
+        // allocator adaptor whose construct without arguments leaves trivially default constructible elements
+        // uninitialized, so a vector can grow without writing them; the other types are still value-initialized
+        template <typename Allocator>
+        class DefaultInitAllocator : public Allocator
+        {
+            using Traits = std::allocator_traits<Allocator>;
+
+        public:
+            template <typename U>
+            struct rebind { using other = DefaultInitAllocator<typename Traits::template rebind_alloc<U>>; };
+
+            using Allocator::Allocator;
+            DefaultInitAllocator() = default;
+            DefaultInitAllocator(const Allocator& allocator) : Allocator(allocator) {}
+            template <typename Other>
+            DefaultInitAllocator(const DefaultInitAllocator<Other>& other) : Allocator(static_cast<const Other&>(other)) {}
+
+            template <typename U>
+            void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>)
+            {
+                if constexpr (std::is_trivially_default_constructible_v<U>)
+                    ::new (static_cast<void*>(p)) U;
+                else
+                    ::new (static_cast<void*>(p)) U();
+            }
+
+            template <typename U, typename... Args>
+            void construct(U* p, Args&&... args)
+            {
+                Traits::construct(static_cast<Allocator&>(*this), p, std::forward<Args>(args)...);
+            }
+        };
+    }
+
     /// <summary>
-    /// Implementation of a 2D vector using monodimensional vector for cache efficiency
+    /// Implementation of a 2D vector using monodimensional vector for cache efficiency.
+    /// Layout decides where each element is stored (see matrix_layout.h), iterators always walk rows top to bottom.
+    /// Allocator provides the storage, e.g. AlignedAllocator, HugePageAllocator or ArenaAllocator (see allocators.h).
+    /// Rows are appended with geometric capacity growth, ReserveRows avoids the reallocations when the final height
+    /// is known.
     /// </summary>
-    template<typename T>
+    template<typename T, typename Layout = RowMajorLayout, typename Allocator = std::allocator<T>>
     class Matrix
     {
         // -------------------------------------------------------------------- fields
     private:
+        using Storage = std::vector<T, detail::DefaultInitAllocator<Allocator>>;
+
         size_t width_ = 0;
-        std::vector<T> vector_;
+        size_t height_ = 0;
+        Storage vector_;
 
         // -------------------------------------------------------------------- methods
     public:
         Matrix() : Matrix(0) {}
-        Matrix(size_t width) : width_(width) { vector_.resize(width); }
+        explicit Matrix(const Allocator& allocator) : Matrix(0, allocator) {}
+
+        Matrix(size_t width, const Allocator& allocator = Allocator()) : width_(width), height_(width == 0 ? 0 : 1), vector_(allocator)
+        {
+            ResizeStorage(vector_, Layout::GetStorageSize(width_, height_), true);
+        }
 
-        Matrix(size_t width, const std::vector<T>& vect) : width_(width)
+        /// vect holds the elements in row-major order
+        Matrix(size_t width, const std::vector<T>& vect, const Allocator& allocator = Allocator())
+            : width_(width), height_(width == 0 ? 0 : vect.size() / width), vector_(allocator)
         {
-            vector_ = vect;
+            if constexpr (Layout::kIsRowMajor)
+            {
+                vector_.assign(vect.begin(), vect.end());
+            }
+            else
+            {
+                ResizeStorage(vector_, Layout::GetStorageSize(width_, height_), true);
+                for (size_t y = 0; y < height_; ++y)
+                    for (size_t x = 0; x < width_; ++x)
+                        Get(x, y) = vect[width_ * y + x];
+            }
         }
 
         size_t GetSizeX() const { return width_; }
-        size_t GetSizeY() const { return width_ == 0 ? 0 : vector_.size() / width_; }
+        size_t GetSizeY() const { return height_; }
+
+        /// appends a row of value-initialized elements
+        void IncreaseSizeY() { EmplaceRow(); }
 
-        void IncreaseSizeY() { vector_.resize(vector_.size() + width_); }
-        void Resize(size_t width, size_t height)
+        /// makes room for rows rows without reallocating, at the current width
+        void ReserveRows(size_t rows) { vector_.reserve(Layout::GetStorageSize(width_, rows)); }
+
+        /// appends a copy of row, which must have GetSizeX() elements; the first row of an empty matrix sets the width
+        void AppendRow(std::span<const T> row)
         {
-            width_ = width;
-            vector_.resize(width * height);
+            if (height_ == 0)
+                width_ = row.size();
+            assert(row.size() == width_);
+            if (width_ == 0)
+                return;
+            // growing may free the storage row points into, append a copy then
+            if (IsInStorage(row.data()))
+            {
+                const std::vector<T> copy(row.begin(), row.end());
+                AppendRow(copy);
+                return;
+            }
+
+            Grow(Layout::GetStorageSize(width_, height_ + 1));
+            if constexpr (Layout::kIsRowMajor)
+            {
+                vector_.insert(vector_.end(), row.begin(), row.end());
+            }
+            else
+            {
+                ResizeStorage(vector_, Layout::GetStorageSize(width_, height_ + 1), true);
+                for (size_t x = 0; x < width_; ++x)
+                    vector_[Layout::GetIndex(x, height_, width_)] = row[x];
+            }
+            ++height_;
+        }
+
+        /// appends a row whose elements are each constructed from args, value-initialized without args;
+        /// a zero-width matrix has no rows, so this does nothing until the width is set
+        template <typename... Args>
+        void EmplaceRow(const Args&... args)
+        {
+            if (width_ == 0)
+                return;
+            // same for arguments referring to elements
+            if ((IsInStorage(std::addressof(args)) || ...))
+            {
+                std::apply([&](const auto&... copies) { EmplaceRow(copies...); }, std::tuple<Args...>(args...));
+                return;
+            }
+
+            Grow(Layout::GetStorageSize(width_, height_ + 1));
+            if constexpr (Layout::kIsRowMajor)
+            {
+                // the allocator's construct without arguments leaves trivial elements uninitialized
+                if constexpr (sizeof...(Args) == 0)
+                    ResizeStorage(vector_, vector_.size() + width_, true);
+                else
+                    for (size_t x = 0; x < width_; ++x)
+                        vector_.emplace_back(args...);
+            }
+            else
+            {
+                ResizeStorage(vector_, Layout::GetStorageSize(width_, height_ + 1), true);
+                for (size_t x = 0; x < width_; ++x)
+                    vector_[Layout::GetIndex(x, height_, width_)] = T(args...);
+            }
+            ++height_;
+        }
+
+        /// elements keep their (x, y) position when they are still inside the matrix, new ones are value-initialized;
+        /// a zero width leaves no rows
+        void Resize(size_t width, size_t height) { Resize(width, height, true); }
+
+        /// same as Resize, but new elements of a trivially default constructible T are left uninitialized
+        void ResizeUninitialized(size_t width, size_t height) { Resize(width, height, false); }
+
+        void Clear() { vector_.clear(); width_ = 0; height_ = 0; }
+
+        const T& Get(size_t x, size_t y) const
+        {
+            CheckBounds("Get", x, y);
+            return vector_[Layout::GetIndex(x, y, width_)];
+        }
+
+        T& Get(size_t x, size_t y)
+        {
+            CheckBounds("Get", x, y);
+            return vector_[Layout::GetIndex(x, y, width_)];
+        }
+
+        /// raw storage, laid out as Layout says; accesses through it are never bounds checked
+        T* GetData() { return vector_.data(); }
+        const T* GetData() const { return vector_.data(); }
+
+        Allocator GetAllocator() const { return vector_.get_allocator(); }
+
+        // -------------------------------------------------------------------- views (layouts with contiguous rows only)
+        // views don't own the elements, they are invalidated like iterators when the matrix is resized
+    public:
+        /// first element of row y, walking it with a pointer skips the index math of Get for each element
+        T* RowPtr(size_t y) requires Layout::kHasContiguousRows
+        {
+            CheckBounds("RowPtr", 0, y);
+            return vector_.data() + GetRowStride() * y;
+        }
+
+        const T* RowPtr(size_t y) const requires Layout::kHasContiguousRows
+        {
+            CheckBounds("RowPtr", 0, y);
+            return vector_.data() + GetRowStride() * y;
+        }
+
+        std::span<T> Row(size_t y) requires Layout::kHasContiguousRows
+        {
+            CheckBounds("Row", 0, y);
+            return AsView().Row(y);
+        }
+
+        std::span<const T> Row(size_t y) const requires Layout::kHasContiguousRows
+        {
+            CheckBounds("Row", 0, y);
+            return AsView().Row(y);
+        }
+
+        StridedSpan<T> Col(size_t x) requires Layout::kHasContiguousRows
+        {
+            CheckRegion("Col", x, 0, 1, height_);
+            return AsView().Col(x);
+        }
+
+        StridedSpan<const T> Col(size_t x) const requires Layout::kHasContiguousRows
+        {
+            CheckRegion("Col", x, 0, 1, height_);
+            return AsView().Col(x);
+        }
+
+        MatrixView<T> SubMatrix(size_t x, size_t y, size_t width, size_t height) requires Layout::kHasContiguousRows
+        {
+            CheckRegion("SubMatrix", x, y, width, height);
+            return AsView().SubMatrix(x, y, width, height);
+        }
+
+        MatrixView<const T> SubMatrix(size_t x, size_t y, size_t width, size_t height) const requires Layout::kHasContiguousRows
+        {
+            CheckRegion("SubMatrix", x, y, width, height);
+            return AsView().SubMatrix(x, y, width, height);
         }
-        void Clear() { vector_.clear(); width_ = 0; }
 
-        const T& Get(size_t x, size_t y) const { return vector_[width_ * y + x]; }
-        T& Get(size_t x, size_t y) { return vector_[width_ * y + x]; }
+        MatrixView<T> AsView() requires Layout::kHasContiguousRows
+        {
+            return MatrixView<T>(vector_.data(), width_, height_, GetRowStride());
+        }
+
+        MatrixView<const T> AsView() const requires Layout::kHasContiguousRows
+        {
+            return MatrixView<const T>(vector_.data(), width_, height_, GetRowStride());
+        }
+
+    private:
+        size_t GetRowStride() const { return Layout::GetIndex(0, 1, width_); }
+
+        // a matrix with rows has a non-zero width, so x == 0 is valid for RowPtr on any existing row
+        void CheckBounds([[maybe_unused]] const char* function, size_t x, size_t y) const
+        {
+#ifdef NBKIT_MATRIX_BOUNDS_CHECK
+            if (x >= width_ || y >= height_)
+                detail::ReportOutOfBounds(function, x, y, width_, height_);
+#else
+            NBKIT_ASSUME(x < width_ && y < height_);
+#endif
+        }
+
+        // the region [x, x + width) x [y, y + height) must lie inside the matrix, empty regions may touch its edges
+        void CheckRegion([[maybe_unused]] const char* function, [[maybe_unused]] size_t x, [[maybe_unused]] size_t y,
+                         [[maybe_unused]] size_t width, [[maybe_unused]] size_t height) const
+        {
+#ifdef NBKIT_MATRIX_BOUNDS_CHECK
+            if (x > width_ || width > width_ - x || y > height_ || height > height_ - y)
+                detail::ReportRegionOutOfBounds(function, x, y, width, height, width_, height_);
+#endif
+        }
+
+        // -------------------------------------------------------------------- storage
+        bool IsInStorage(const void* pointer) const
+        {
+            const std::less<const void*> less;
+            return !less(pointer, vector_.data()) && less(pointer, vector_.data() + vector_.size());
+        }
+
+        // grows the capacity geometrically, so appending rows one by one costs amortized constant time per element
+        void Grow(size_t size)
+        {
+            if (size > vector_.capacity())
+                vector_.reserve(std::max(size, 2 * vector_.capacity()));
+        }
+
+        static void ResizeStorage(Storage& storage, size_t size, bool initialize)
+        {
+            const size_t old_size = storage.size();
+            storage.resize(size);
+            if constexpr (std::is_trivially_default_constructible_v<T>)
+            {
+                if (initialize && size > old_size)
+                    std::uninitialized_value_construct(storage.data() + old_size, storage.data() + size);
+            }
+        }
+
+        void Resize(size_t width, size_t height, bool initialize)
+        {
+            if (width == 0)
+                height = 0;
+            if (width == width_ || width_ == 0 || height_ == 0 || width == 0)
+            {
+                if constexpr (!Layout::kIsRowMajor)
+                    ResetDroppedRows(width, height);
+                width_ = width;
+                height_ = height;
+                ResizeStorage(vector_, Layout::GetStorageSize(width, height), initialize);
+                return;
+            }
+
+            if constexpr (Layout::kIsRowMajor)
+                RelocateRows(width, height, initialize);
+            else
+            {
+                Storage resized(vector_.get_allocator());
+                ResizeStorage(resized, Layout::GetStorageSize(width, height), initialize);
+                for (size_t y = 0; y < std::min(height, height_); ++y)
+                    for (size_t x = 0; x < std::min(width, width_); ++x)
+                        resized[Layout::GetIndex(x, y, width)] = std::move(Get(x, y));
+
+                width_ = width;
+                height_ = height;
+                vector_ = std::move(resized);
+            }
+        }
+
+        // tiles and Morton blocks round the storage up to whole tile rows, so rows dropped by a shrink inside the
+        // last tile row stay in storage; reset them, or growing back would return their old values
+        void ResetDroppedRows(size_t width, size_t height)
+        {
+            if (width != width_ || height >= height_)
+                return;
+            const size_t kept_size = Layout::GetStorageSize(width, height);
+            for (size_t y = height; y < height_; ++y)
+                for (size_t x = 0; x < width_; ++x)
+                    if (const size_t index = Layout::GetIndex(x, y, width_); index < kept_size)
+                        vector_[index] = T();
+        }
+
+        // row-major width change in place: narrower rows move front to front, wider rows back to back, so no row
+        // overwrites one that hasn't moved yet. Slots left behind by the moves become new elements.
+        void RelocateRows(size_t width, size_t height, bool initialize)
+        {
+            const size_t rows = std::min(height, height_);
+            const size_t old_width = width_;
+            const size_t old_size = vector_.size();
+            const bool reset = initialize || !std::is_trivially_default_constructible_v<T>;
+
+            if (width < old_width)
+            {
+                T* data = vector_.data();
+                for (size_t y = 1; y < rows; ++y)
+                    std::move(data + y * old_width, data + y * old_width + width, data + y * width);
+                if (reset)
+                    std::fill(data + rows * width, data + std::min(old_size, width * height), T());
+                ResizeStorage(vector_, width * height, initialize);
+            }
+            else
+            {
+                Grow(width * height);
+                ResizeStorage(vector_, std::max(old_size, width * height), initialize);
+                T* data = vector_.data();
+                for (size_t y = rows; y-- > 0;)
+                {
+                    if (y > 0)
+                        std::move_backward(data + y * old_width, data + (y + 1) * old_width, data + y * width + old_width);
+                    if (reset)
+                        std::fill(data + y * width + old_width, data + (y + 1) * width, T());
+                }
+                vector_.resize(width * height);
+            }
+
+            width_ = width;
+            height_ = height;
+        }
 
         // -------------------------------------------------------------------- iterator
     public:
@@ -53,10 +433,10 @@ namespace nbkit
             using reference = T&;
 
         private:
-            typename std::vector<T>::iterator it_;
+            typename Storage::iterator it_;
 
         public:
-            Iterator(typename std::vector<T>::iterator it) : it_(it) {}
+            Iterator(typename Storage::iterator it) : it_(it) {}
 
             reference operator*() { return *it_; }
             pointer operator->() { return &(*it_); }
@@ -78,9 +458,6 @@ namespace nbkit
             reference operator[](difference_type n) const { return *(it_ + n); }
         };
 
-        Iterator begin() { return Iterator(vector_.begin()); }
-        Iterator end() { return Iterator(vector_.end()); }
-
         // -------------------------------------------------------------------- const Iterator
         class ConstIterator
         {
@@ -92,10 +469,10 @@ namespace nbkit
             using reference = const T&;
 
         private:
-            typename std::vector<T>::const_iterator it_;
+            typename Storage::const_iterator it_;
 
         public:
-            ConstIterator(typename std::vector<T>::const_iterator it) : it_(it) {}
+            ConstIterator(typename Storage::const_iterator it) : it_(it) {}
 
             reference operator*() const { return *it_; }
             pointer operator->() const { return &(*it_); }
@@ -117,7 +494,93 @@ namespace nbkit
             reference operator[](difference_type n) const { return *(it_ + n); }
         };
 
-        ConstIterator begin() const { return ConstIterator(vector_.begin()); }
-        ConstIterator end() const { return ConstIterator(vector_.end()); }
+        // -------------------------------------------------------------------- layout iterator
+        /// walks elements in row-major order through Get, used by layouts that don't store rows contiguously
+        template <bool IsConst>
+        class LayoutIterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::conditional_t<IsConst, const T, T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type&;
+
+        private:
+            using MatrixPtr = std::conditional_t<IsConst, const Matrix*, Matrix*>;
+
+            MatrixPtr matrix_ = nullptr;
+            size_t x_ = 0;
+            size_t y_ = 0;
+
+        public:
+            LayoutIterator() = default;
+            LayoutIterator(MatrixPtr matrix, size_t index) : matrix_(matrix) { SetIndex(index); }
+
+            reference operator*() const { return matrix_->Get(x_, y_); }
+            pointer operator->() const { return &matrix_->Get(x_, y_); }
+            LayoutIterator& operator++() { if (++x_ == matrix_->width_) { x_ = 0; ++y_; } return *this; }
+            LayoutIterator operator++(int) { LayoutIterator temp = *this; ++*this; return temp; }
+            LayoutIterator& operator--() { if (x_-- == 0) { x_ = matrix_->width_ - 1; --y_; } return *this; }
+            LayoutIterator operator--(int) { LayoutIterator temp = *this; --*this; return temp; }
+            LayoutIterator operator+(difference_type n) const { return LayoutIterator(matrix_, GetIndex() + n); }
+            LayoutIterator operator-(difference_type n) const { return LayoutIterator(matrix_, GetIndex() - n); }
+            LayoutIterator& operator+=(difference_type n) { SetIndex(GetIndex() + n); return *this; }
+            LayoutIterator& operator-=(difference_type n) { SetIndex(GetIndex() - n); return *this; }
+            difference_type operator-(const LayoutIterator& other) const { return static_cast<difference_type>(GetIndex() - other.GetIndex()); }
+            bool operator==(const LayoutIterator& other) const { return x_ == other.x_ && y_ == other.y_; }
+            bool operator!=(const LayoutIterator& other) const { return !(*this == other); }
+            bool operator<(const LayoutIterator& other) const { return GetIndex() < other.GetIndex(); }
+            bool operator<=(const LayoutIterator& other) const { return GetIndex() <= other.GetIndex(); }
+            bool operator>(const LayoutIterator& other) const { return GetIndex() > other.GetIndex(); }
+            bool operator>=(const LayoutIterator& other) const { return GetIndex() >= other.GetIndex(); }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+        private:
+            size_t GetIndex() const { return y_ * matrix_->width_ + x_; }
+
+            void SetIndex(size_t index)
+            {
+                const size_t width = matrix_->width_;
+                x_ = width == 0 ? 0 : index % width;
+                y_ = width == 0 ? 0 : index / width;
+            }
+        };
+
+        // -------------------------------------------------------------------- begin / end
+        using iterator = std::conditional_t<Layout::kIsRowMajor, Iterator, LayoutIterator<false>>;
+        using const_iterator = std::conditional_t<Layout::kIsRowMajor, ConstIterator, LayoutIterator<true>>;
+
+        iterator begin()
+        {
+            if constexpr (Layout::kIsRowMajor)
+                return Iterator(vector_.begin());
+            else
+                return LayoutIterator<false>(this, 0);
+        }
+
+        iterator end()
+        {
+            if constexpr (Layout::kIsRowMajor)
+                return Iterator(vector_.end());
+            else
+                return LayoutIterator<false>(this, width_ * height_);
+        }
+
+        const_iterator begin() const
+        {
+            if constexpr (Layout::kIsRowMajor)
+                return ConstIterator(vector_.begin());
+            else
+                return LayoutIterator<true>(this, 0);
+        }
+
+        const_iterator end() const
+        {
+            if constexpr (Layout::kIsRowMajor)
+                return ConstIterator(vector_.end());
+            else
+                return LayoutIterator<true>(this, width_ * height_);
+        }
     };
 }
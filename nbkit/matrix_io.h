@@ -0,0 +1,376 @@
+#pragma once
+
+#include "nbkit/matrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define NBKIT_MATRIX_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace nbkit
+{
+    // Matrix file: a 64-byte MatrixFileHeader then height rows of row_stride elements each, the first width being the
+    // row (the rest is padding). Elements are stored as in memory, so a file is only read on hosts with the same
+    // endianness, which the endian_tag checks. The data starts at a 64-byte boundary so it can be mapped and used as is.
+
+    enum class ElementKind : uint32_t { kRaw, kSigned, kUnsigned, kFloat };
+
+    struct MatrixFileHeader
+    {
+        static constexpr char kMagic[8] = { 'N', 'B', 'K', 'M', 'A', 'T', 'R', 'X' };
+        static constexpr uint32_t kVersion = 1;
+        static constexpr uint32_t kEndianTag = 0x01020304;
+        static constexpr uint64_t kDataOffset = 64;
+
+        char magic[8] = {};
+        uint32_t version = 0;
+        uint32_t endian_tag = 0;
+        ElementKind element_kind = ElementKind::kRaw;
+        uint32_t element_size = 0;
+        uint64_t width = 0;
+        uint64_t height = 0;
+        uint64_t row_stride = 0;
+        uint64_t data_offset = 0;
+        uint8_t reserved[8] = {};
+    };
+    static_assert(sizeof(MatrixFileHeader) == MatrixFileHeader::kDataOffset);
+
+    namespace detail
+    {
+        template <typename T>
+        constexpr ElementKind GetElementKind()
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                return ElementKind::kFloat;
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+                return ElementKind::kSigned;
+            else if constexpr (std::is_integral_v<T>)
+                return ElementKind::kUnsigned;
+            else
+                return ElementKind::kRaw;
+        }
+
+        template <typename T>
+        MatrixFileHeader MakeMatrixFileHeader(size_t width, size_t height, size_t row_stride)
+        {
+            MatrixFileHeader header;
+            std::memcpy(header.magic, MatrixFileHeader::kMagic, sizeof(header.magic));
+            header.version = MatrixFileHeader::kVersion;
+            header.endian_tag = MatrixFileHeader::kEndianTag;
+            header.element_kind = GetElementKind<T>();
+            header.element_size = sizeof(T);
+            header.width = width;
+            header.height = height;
+            header.row_stride = row_stride;
+            header.data_offset = MatrixFileHeader::kDataOffset;
+            return header;
+        }
+
+        // size of the data the header describes, 0 when the header doesn't describe a T matrix
+        template <typename T>
+        uint64_t CheckMatrixFileHeader(const MatrixFileHeader& header)
+        {
+            if (std::memcmp(header.magic, MatrixFileHeader::kMagic, sizeof(header.magic)) != 0
+                || header.version != MatrixFileHeader::kVersion || header.endian_tag != MatrixFileHeader::kEndianTag
+                || header.element_kind != GetElementKind<T>() || header.element_size != sizeof(T)
+                || header.data_offset < sizeof(MatrixFileHeader) || header.row_stride < header.width)
+                return 0;
+
+            // rejects sizes whose product or sum overflows, or that no file, stream or address space can hold
+            const uint64_t max_size = std::min<uint64_t>(std::numeric_limits<std::streamsize>::max(), SIZE_MAX);
+            if (header.height != 0 && header.row_stride > max_size / sizeof(T) / header.height)
+                return 0;
+            const uint64_t data_size = header.row_stride * header.height * sizeof(T);
+            if (header.data_offset > max_size - data_size)
+                return 0;
+            return header.data_offset + data_size;
+        }
+
+        inline constexpr uint64_t kUnknownSize = UINT64_MAX;
+
+        // bytes left in the stream, kUnknownSize when it can't seek (pipes, sockets...)
+        inline uint64_t GetRemainingSize(std::istream& in)
+        {
+            const std::streampos position = in.tellg();
+            if (position == std::streampos(-1))
+                return kUnknownSize;
+            in.seekg(0, std::ios::end);
+            const std::streampos end = in.tellg();
+            in.clear();
+            in.seekg(position);
+            return end == std::streampos(-1) ? kUnknownSize : static_cast<uint64_t>(end - position);
+        }
+
+        // reads count elements in chunks, so memory only grows with the data the stream actually holds
+        template <typename T>
+        bool ReadElements(std::istream& in, size_t count, std::vector<T>& elements)
+        {
+            constexpr size_t kChunkSize = size_t { 1 } << 16;
+            elements.clear();
+            while (elements.size() < count)
+            {
+                const size_t read = elements.size();
+                const size_t chunk = std::min(kChunkSize, count - read);
+                elements.resize(read + chunk);
+                if (!in.read(reinterpret_cast<char*>(elements.data() + read), static_cast<std::streamsize>(chunk * sizeof(T))))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    /// writes the matrix in the matrix file format, layouts with contiguous rows keep their row stride and are written
+    /// straight from their storage, the others are written row by row
+    template <typename T, typename Layout, typename Allocator>
+    bool SaveMatrix(const Matrix<T, Layout, Allocator>& matrix, std::ostream& out)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be saved");
+
+        const size_t width = matrix.GetSizeX();
+        const size_t height = matrix.GetSizeY();
+        size_t row_stride = width;
+        if constexpr (Layout::kHasContiguousRows)
+            row_stride = matrix.AsView().GetRowStride();
+
+        const MatrixFileHeader header = detail::MakeMatrixFileHeader<T>(width, height, row_stride);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (height == 0)
+            return static_cast<bool>(out);
+
+        if constexpr (Layout::kHasContiguousRows)
+        {
+            // the last row may have no padding in storage, it is written from a zeroed row
+            const std::vector<T> padding(row_stride - width, T {});
+            out.write(reinterpret_cast<const char*>(matrix.GetData()), static_cast<std::streamsize>(((height - 1) * row_stride + width) * sizeof(T)));
+            out.write(reinterpret_cast<const char*>(padding.data()), static_cast<std::streamsize>(padding.size() * sizeof(T)));
+        }
+        else
+        {
+            std::vector<T> row(width);
+            for (size_t y = 0; y < height; ++y)
+            {
+                for (size_t x = 0; x < width; ++x)
+                    row[x] = matrix.Get(x, y);
+                out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(width * sizeof(T)));
+            }
+        }
+        return static_cast<bool>(out);
+    }
+
+    template <typename T, typename Layout, typename Allocator>
+    bool SaveMatrix(const Matrix<T, Layout, Allocator>& matrix, const std::filesystem::path& path)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        return out && SaveMatrix(matrix, out);
+    }
+
+    /// reads a matrix file into matrix, false if the stream doesn't hold a matrix of T (matrix is then left unspecified);
+    /// nothing is allocated for data the stream doesn't hold, whatever size a corrupt header claims
+    template <typename T, typename Layout, typename Allocator>
+    bool LoadMatrix(std::istream& in, Matrix<T, Layout, Allocator>& matrix)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be loaded");
+
+        MatrixFileHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+        const uint64_t size = detail::CheckMatrixFileHeader<T>(header);
+        const uint64_t remaining = detail::GetRemainingSize(in);
+        if (size == 0 || (remaining != detail::kUnknownSize && size - sizeof(header) > remaining))
+            return false;
+        in.ignore(static_cast<std::streamsize>(header.data_offset - sizeof(header)));
+
+        const auto width = static_cast<size_t>(header.width);
+        const auto height = static_cast<size_t>(header.height);
+        const auto row_stride = static_cast<size_t>(header.row_stride);
+        if (remaining == detail::kUnknownSize)
+        {
+            std::vector<T> elements;
+            if (!detail::ReadElements(in, row_stride * height, elements))
+                return false;
+            matrix.Clear();
+            matrix.Resize(width, height);
+            for (size_t y = 0; y < height; ++y)
+                for (size_t x = 0; x < width; ++x)
+                    matrix.Get(x, y) = elements[row_stride * y + x];
+            return true;
+        }
+
+        // the old elements are overwritten, clearing first saves Resize from relocating them
+        matrix.Clear();
+        matrix.Resize(width, height);
+        if (height == 0)
+            return true;
+
+        if constexpr (Layout::kHasContiguousRows)
+        {
+            if (matrix.AsView().GetRowStride() == row_stride)
+            {
+                const size_t count = (height - 1) * row_stride + width;
+                in.read(reinterpret_cast<char*>(matrix.GetData()), static_cast<std::streamsize>(count * sizeof(T)));
+                in.ignore(static_cast<std::streamsize>((row_stride - width) * sizeof(T)));
+                return static_cast<bool>(in);
+            }
+        }
+
+        std::vector<T> row(row_stride);
+        for (size_t y = 0; y < height; ++y)
+        {
+            if (!in.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(row_stride * sizeof(T))))
+                return false;
+            for (size_t x = 0; x < width; ++x)
+                matrix.Get(x, y) = row[x];
+        }
+        return true;
+    }
+
+    template <typename T, typename Layout, typename Allocator>
+    bool LoadMatrix(const std::filesystem::path& path, Matrix<T, Layout, Allocator>& matrix)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return in && LoadMatrix(in, matrix);
+    }
+
+    enum class MapMode { kReadOnly, kReadWrite };
+
+    /// <summary>
+    /// Matrix file mapped in memory: opening only checks the header, pages are read by the system on first access,
+    /// so opening takes the same time whatever the file size. With kReadWrite, writes go back to the file.
+    /// Needs mmap (Linux, macOS...), Open fails elsewhere; use LoadMatrix there.
+    /// </summary>
+    template <typename T>
+    class MappedMatrix
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be mapped");
+
+        // -------------------------------------------------------------------- fields
+    private:
+        void* mapping_ = nullptr;
+        size_t mapping_size_ = 0;
+        T* data_ = nullptr;
+        size_t width_ = 0;
+        size_t height_ = 0;
+        size_t row_stride_ = 0;
+        MapMode mode_ = MapMode::kReadOnly;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        MappedMatrix() = default;
+        ~MappedMatrix() { Close(); }
+
+        MappedMatrix(const MappedMatrix&) = delete;
+        MappedMatrix& operator = (const MappedMatrix&) = delete;
+
+        MappedMatrix(MappedMatrix&& other) noexcept { *this = std::move(other); }
+        MappedMatrix& operator = (MappedMatrix&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                mapping_ = std::exchange(other.mapping_, nullptr);
+                mapping_size_ = std::exchange(other.mapping_size_, 0);
+                data_ = std::exchange(other.data_, nullptr);
+                width_ = std::exchange(other.width_, 0);
+                height_ = std::exchange(other.height_, 0);
+                row_stride_ = std::exchange(other.row_stride_, 0);
+                mode_ = other.mode_;
+            }
+            return *this;
+        }
+
+        /// false if the file can't be mapped or doesn't hold a matrix of T
+        bool Open(const std::filesystem::path& path, MapMode mode = MapMode::kReadOnly)
+        {
+            Close();
+#ifdef NBKIT_MATRIX_MMAP
+            const int fd = open(path.c_str(), mode == MapMode::kReadWrite ? O_RDWR : O_RDONLY);
+            if (fd < 0)
+                return false;
+
+            struct stat status {};
+            const bool has_header = fstat(fd, &status) == 0 && static_cast<uint64_t>(status.st_size) >= sizeof(MatrixFileHeader);
+            void* mapping = MAP_FAILED;
+            if (has_header)
+            {
+                const int protection = mode == MapMode::kReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+                mapping = mmap(nullptr, static_cast<size_t>(status.st_size), protection, MAP_SHARED, fd, 0);
+            }
+            close(fd);
+            if (mapping == MAP_FAILED)
+                return false;
+
+            mapping_ = mapping;
+            mapping_size_ = static_cast<size_t>(status.st_size);
+
+            MatrixFileHeader header;
+            std::memcpy(&header, mapping_, sizeof(header));
+            const uint64_t size = detail::CheckMatrixFileHeader<T>(header);
+            if (size == 0 || size > mapping_size_ || header.data_offset % alignof(T) != 0)
+            {
+                Close();
+                return false;
+            }
+
+            data_ = reinterpret_cast<T*>(static_cast<std::byte*>(mapping_) + header.data_offset);
+            width_ = static_cast<size_t>(header.width);
+            height_ = static_cast<size_t>(header.height);
+            row_stride_ = static_cast<size_t>(header.row_stride);
+            mode_ = mode;
+            return true;
+#else
+            (void)path;
+            (void)mode;
+            return false;
+#endif
+        }
+
+        void Close()
+        {
+#ifdef NBKIT_MATRIX_MMAP
+            if (mapping_ != nullptr)
+                munmap(mapping_, mapping_size_);
+#endif
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            data_ = nullptr;
+            width_ = 0;
+            height_ = 0;
+            row_stride_ = 0;
+        }
+
+        bool IsOpen() const { return mapping_ != nullptr; }
+        bool IsWritable() const { return IsOpen() && mode_ == MapMode::kReadWrite; }
+
+        size_t GetSizeX() const { return width_; }
+        size_t GetSizeY() const { return height_; }
+        size_t GetRowStride() const { return row_stride_; }
+
+        const T& Get(size_t x, size_t y) const { return data_[row_stride_ * y + x]; }
+        const T* GetData() const { return data_; }
+
+        MatrixView<const T> AsView() const { return MatrixView<const T>(data_, width_, height_, row_stride_); }
+
+        /// only for files opened with kReadWrite, writing through a read-only mapping crashes
+        MatrixView<T> AsMutableView() const
+        {
+            assert(IsWritable());
+            return MatrixView<T>(data_, width_, height_, row_stride_);
+        }
+    };
+}
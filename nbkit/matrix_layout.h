@@ -0,0 +1,130 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+namespace nbkit
+{
+    // A layout maps the (x, y) coordinates of a Matrix to an index in its storage. It only depends on the matrix
+    // width, so it is a stateless policy:
+    //   kIsRowMajor                    storage is the plain row-major sequence of elements (no padding)
+    //   kHasContiguousRows             each row is contiguous and rows start GetIndex(0, 1, width) elements apart,
+    //                                  which is all row views need
+    //   GetStorageSize(width, height)  number of elements to allocate, padding included
+    //   GetIndex(x, y, width)          storage index of (x, y)
+
+    /// <summary>
+    /// Default layout: rows stored one after the other, best for row walks
+    /// </summary>
+    struct RowMajorLayout
+    {
+        static constexpr bool kIsRowMajor = true;
+        static constexpr bool kHasContiguousRows = true;
+
+        static constexpr size_t GetStorageSize(size_t width, size_t height) { return width * height; }
+        static constexpr size_t GetIndex(size_t x, size_t y, size_t width) { return width * y + x; }
+    };
+
+    /// <summary>
+    /// Row-major with each row stride rounded up to a multiple of StrideMultiple elements, so that with aligned storage
+    /// every row starts on its own cache line (see CacheLinePaddedLayout) and vector loops need no unaligned head.
+    /// </summary>
+    template <size_t StrideMultiple>
+    struct PaddedLayout
+    {
+        static_assert(StrideMultiple > 0, "StrideMultiple can't be 0");
+
+        static constexpr bool kIsRowMajor = false;
+        static constexpr bool kHasContiguousRows = true;
+
+        static constexpr size_t GetRowStride(size_t width) { return (width + StrideMultiple - 1) / StrideMultiple * StrideMultiple; }
+        static constexpr size_t GetStorageSize(size_t width, size_t height) { return GetRowStride(width) * height; }
+        static constexpr size_t GetIndex(size_t x, size_t y, size_t width) { return GetRowStride(width) * y + x; }
+    };
+
+    /// rows padded to whole 64-byte cache lines of T
+    template <typename T>
+    using CacheLinePaddedLayout = PaddedLayout<64 / std::gcd(size_t { 64 }, sizeof(T))>;
+
+    /// <summary>
+    /// Stores the matrix as row-major tiles of TileWidth x TileHeight elements, each tile row-major too.
+    /// Neighbours in both directions share a tile, so column walks and 2D stencils touch a few cache lines and pages
+    /// instead of one per row. Edge tiles are padded, sizes must be powers of two.
+    /// </summary>
+    template <size_t TileWidth, size_t TileHeight>
+    struct TiledLayout
+    {
+        static_assert(std::has_single_bit(TileWidth) && std::has_single_bit(TileHeight), "Tile sizes must be powers of two");
+
+        static constexpr bool kIsRowMajor = false;
+        static constexpr bool kHasContiguousRows = false;
+        static constexpr size_t kTileWidth = TileWidth;
+        static constexpr size_t kTileHeight = TileHeight;
+
+    private:
+        static constexpr size_t kTileSize = TileWidth * TileHeight;
+        static constexpr int kShiftX = std::countr_zero(TileWidth);
+        static constexpr int kShiftY = std::countr_zero(TileHeight);
+
+        static constexpr size_t GetTilesPerRow(size_t width) { return (width + TileWidth - 1) >> kShiftX; }
+
+    public:
+        static constexpr size_t GetStorageSize(size_t width, size_t height)
+        {
+            return GetTilesPerRow(width) * ((height + TileHeight - 1) >> kShiftY) * kTileSize;
+        }
+
+        static constexpr size_t GetIndex(size_t x, size_t y, size_t width)
+        {
+            const size_t tile = (y >> kShiftY) * GetTilesPerRow(width) + (x >> kShiftX);
+            return tile * kTileSize + ((y & (TileHeight - 1)) << kShiftX) + (x & (TileWidth - 1));
+        }
+    };
+
+    /// <summary>
+    /// Row-major tiles of TileSize x TileSize elements stored in Z-order (Morton) inside, so any small square
+    /// neighbourhood is close in memory regardless of the walk direction. TileSize must be a power of two up to 65536.
+    /// </summary>
+    template <size_t TileSize>
+    struct MortonLayout
+    {
+        static_assert(std::has_single_bit(TileSize) && TileSize <= 65536, "TileSize must be a power of two up to 65536");
+
+        static constexpr bool kIsRowMajor = false;
+        static constexpr bool kHasContiguousRows = false;
+        static constexpr size_t kTileWidth = TileSize;
+        static constexpr size_t kTileHeight = TileSize;
+
+    private:
+        static constexpr int kShift = std::countr_zero(TileSize);
+
+        static constexpr size_t GetTilesPerRow(size_t width) { return (width + TileSize - 1) >> kShift; }
+
+        // spreads the low 16 bits of value over the even bits
+        static constexpr uint32_t SpreadBits(uint32_t value)
+        {
+            value &= 0x0000FFFF;
+            value = (value | (value << 8)) & 0x00FF00FF;
+            value = (value | (value << 4)) & 0x0F0F0F0F;
+            value = (value | (value << 2)) & 0x33333333;
+            value = (value | (value << 1)) & 0x55555555;
+            return value;
+        }
+
+    public:
+        static constexpr size_t GetStorageSize(size_t width, size_t height)
+        {
+            return GetTilesPerRow(width) * ((height + TileSize - 1) >> kShift) * TileSize * TileSize;
+        }
+
+        static constexpr size_t GetIndex(size_t x, size_t y, size_t width)
+        {
+            const size_t tile = (y >> kShift) * GetTilesPerRow(width) + (x >> kShift);
+            const auto local_x = static_cast<uint32_t>(x & (TileSize - 1));
+            const auto local_y = static_cast<uint32_t>(y & (TileSize - 1));
+            return tile * TileSize * TileSize + (SpreadBits(local_x) | (SpreadBits(local_y) << 1));
+        }
+    };
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "nbkit/matrix.h"
+#include "nbkit/simd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Elementwise operations and reductions over whole matrices, running the SIMD kernels of simd.h on the storage.
+    /// Elementwise operands must have the same size, out is resized to it and may be one of the operands.
+    /// </summary>
+    namespace matrix_ops
+    {
+        namespace detail
+        {
+            template <typename T, typename Layout, typename Allocator>
+            size_t GetCount(const Matrix<T, Layout, Allocator>& matrix) { return matrix.GetSizeX() * matrix.GetSizeY(); }
+
+            template <typename T, typename Layout, typename Allocator>
+            bool HaveSameSize(const Matrix<T, Layout, Allocator>& a, const Matrix<T, Layout, Allocator>& b)
+            {
+                return a.GetSizeX() == b.GetSizeX() && a.GetSizeY() == b.GetSizeY();
+            }
+
+            // outputs are fully overwritten, so their old elements are dropped rather than relocated by Resize
+            template <typename T, typename Layout, typename Allocator>
+            void ResizeOutput(Matrix<T, Layout, Allocator>& out, size_t width, size_t height)
+            {
+                if (out.GetSizeX() == width && out.GetSizeY() == height)
+                    return;
+                out.Clear();
+                out.ResizeUninitialized(width, height);
+            }
+
+            template <typename T, typename Layout, typename Allocator>
+            void PrepareOutput(const Matrix<T, Layout, Allocator>& a, Matrix<T, Layout, Allocator>& out)
+            {
+                if (&out != &a)
+                    ResizeOutput(out, a.GetSizeX(), a.GetSizeY());
+            }
+
+            // leaves of the recursive transpose, 8 x 8 keeps the 8 destination rows in distinct cache sets even for
+            // power of two widths, where larger square blocks start evicting each other
+            inline constexpr size_t kTransposeBlock = 8;
+
+            // out[x * height + y] = in[y * width + x] over [x0, x1) x [y0, y1). Cache-oblivious: the larger side is halved
+            // until the region is a leaf, so at some depth the source and destination regions fit each cache level.
+            template <typename T>
+            void TransposeRegion(const T* in, T* out, size_t width, size_t height, size_t x0, size_t x1, size_t y0, size_t y1)
+            {
+                if (x1 - x0 <= kTransposeBlock && y1 - y0 <= kTransposeBlock)
+                {
+                    for (size_t y = y0; y < y1; ++y)
+                        for (size_t x = x0; x < x1; ++x)
+                            out[x * height + y] = in[y * width + x];
+                }
+                else if (x1 - x0 >= y1 - y0)
+                {
+                    const size_t middle = x0 + (x1 - x0) / 2;
+                    TransposeRegion(in, out, width, height, x0, middle, y0, y1);
+                    TransposeRegion(in, out, width, height, middle, x1, y0, y1);
+                }
+                else
+                {
+                    const size_t middle = y0 + (y1 - y0) / 2;
+                    TransposeRegion(in, out, width, height, x0, x1, y0, middle);
+                    TransposeRegion(in, out, width, height, x0, x1, middle, y1);
+                }
+            }
+
+            template <typename T>
+            void TransposeOutOfPlace(const T* in, T* out, size_t width, size_t height)
+            {
+                TransposeRegion(in, out, width, height, 0, width, 0, height);
+            }
+
+            // swaps each leaf block above the diagonal with its mirror below it, diagonal blocks with themselves
+            template <typename T>
+            void TransposeSquareInPlace(T* data, size_t side)
+            {
+                for (size_t by = 0; by < side; by += kTransposeBlock)
+                    for (size_t bx = by; bx < side; bx += kTransposeBlock)
+                    {
+                        const size_t end_y = std::min(by + kTransposeBlock, side);
+                        const size_t end_x = std::min(bx + kTransposeBlock, side);
+                        for (size_t y = by; y < end_y; ++y)
+                            for (size_t x = bx == by ? y + 1 : bx; x < end_x; ++x)
+                                std::swap(data[y * side + x], data[x * side + y]);
+                    }
+            }
+        }
+
+        //------ elementwise
+
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void Add(const Matrix<T, Layout, Allocator>& a, const Matrix<T, Layout, Allocator>& b, Matrix<T, Layout, Allocator>& out)
+        {
+            assert(detail::HaveSameSize(a, b));
+            detail::PrepareOutput(a, out);
+            simd::Add(a.GetData(), b.GetData(), out.GetData(), detail::GetCount(a));
+        }
+
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void Scale(const Matrix<T, Layout, Allocator>& a, T factor, Matrix<T, Layout, Allocator>& out)
+        {
+            detail::PrepareOutput(a, out);
+            simd::Scale(a.GetData(), factor, out.GetData(), detail::GetCount(a));
+        }
+
+        /// out = a * b + c elementwise, floating point values are rounded once
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void MultiplyAdd(const Matrix<T, Layout, Allocator>& a, const Matrix<T, Layout, Allocator>& b, const Matrix<T, Layout, Allocator>& c,
+                         Matrix<T, Layout, Allocator>& out)
+        {
+            assert(detail::HaveSameSize(a, b) && detail::HaveSameSize(a, c));
+            detail::PrepareOutput(a, out);
+            simd::MultiplyAdd(a.GetData(), b.GetData(), c.GetData(), out.GetData(), detail::GetCount(a));
+        }
+
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void Clamp(const Matrix<T, Layout, Allocator>& a, T low, T high, Matrix<T, Layout, Allocator>& out)
+        {
+            assert(!(high < low));
+            detail::PrepareOutput(a, out);
+            simd::Clamp(a.GetData(), low, high, out.GetData(), detail::GetCount(a));
+        }
+
+        //------ reductions
+
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        T Sum(const Matrix<T, Layout, Allocator>& a) { return simd::Sum(a.GetData(), detail::GetCount(a)); }
+
+        /// +inf (or the largest value of T) for an empty matrix
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        T Min(const Matrix<T, Layout, Allocator>& a) { return simd::Min(a.GetData(), detail::GetCount(a)); }
+
+        /// -inf (or the lowest value of T) for an empty matrix
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        T Max(const Matrix<T, Layout, Allocator>& a) { return simd::Max(a.GetData(), detail::GetCount(a)); }
+
+        /// sum of the elementwise products, as if both matrices were flat vectors
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        T Dot(const Matrix<T, Layout, Allocator>& a, const Matrix<T, Layout, Allocator>& b)
+        {
+            assert(detail::HaveSameSize(a, b));
+            return simd::Dot(a.GetData(), b.GetData(), detail::GetCount(a));
+        }
+
+        //------ linear algebra
+
+        /// out = a * b, a is a.GetSizeY() rows by a.GetSizeX() columns, out gets the rows of a and the columns of b.
+        /// Runs the blocked kernel of simd::Multiply, out must be a different matrix than a and b.
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void Multiply(const Matrix<T, Layout, Allocator>& a, const Matrix<T, Layout, Allocator>& b, Matrix<T, Layout, Allocator>& out)
+        {
+            assert(a.GetSizeX() == b.GetSizeY());
+            assert(&out != &a && &out != &b);
+            detail::ResizeOutput(out, b.GetSizeX(), a.GetSizeY());
+            simd::Multiply(a.GetData(), b.GetData(), out.GetData(), a.GetSizeY(), a.GetSizeX(), b.GetSizeX());
+        }
+
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        Matrix<T, Layout, Allocator> Multiply(const Matrix<T, Layout, Allocator>& a, const Matrix<T, Layout, Allocator>& b)
+        {
+            Matrix<T, Layout, Allocator> out(a.GetAllocator());
+            Multiply(a, b, out);
+            return out;
+        }
+
+        /// out(y, x) = a(x, y), out must be a different matrix than a
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void Transpose(const Matrix<T, Layout, Allocator>& a, Matrix<T, Layout, Allocator>& out)
+        {
+            assert(&out != &a);
+            detail::ResizeOutput(out, a.GetSizeY(), a.GetSizeX());
+            detail::TransposeOutOfPlace(a.GetData(), out.GetData(), a.GetSizeX(), a.GetSizeY());
+        }
+
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        Matrix<T, Layout, Allocator> Transpose(const Matrix<T, Layout, Allocator>& a)
+        {
+            Matrix<T, Layout, Allocator> out(a.GetAllocator());
+            Transpose(a, out);
+            return out;
+        }
+
+        /// square matrices swap elements in place, the others are transposed from a copy of their elements
+        template <typename T, typename Layout, typename Allocator> requires Layout::kIsRowMajor
+        void TransposeInPlace(Matrix<T, Layout, Allocator>& a)
+        {
+            const size_t width = a.GetSizeX();
+            const size_t height = a.GetSizeY();
+            if (width == height)
+            {
+                detail::TransposeSquareInPlace(a.GetData(), width);
+                return;
+            }
+
+            const std::vector<T> elements(a.GetData(), a.GetData() + width * height);
+            detail::ResizeOutput(a, height, width);
+            detail::TransposeOutOfPlace(elements.data(), a.GetData(), width, height);
+        }
+    }
+}
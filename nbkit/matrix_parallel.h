@@ -0,0 +1,118 @@
+#pragma once
+
+#include "nbkit/matrix.h"
+#include "nbkit/thread_pool.h"
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Parallel algorithms over the contiguous storage of row-major matrices, run on a ThreadPool (the default one
+    /// unless given). The work is cut in chunks of about 64 KB that end on a cache line boundary of the storage, so two
+    /// threads never write the same line when the storage is cache line aligned. Chunks only depend on the matrix
+    /// size, never on the thread count or the scheduling, so results are deterministic.
+    /// </summary>
+    namespace matrix_ops
+    {
+        namespace detail
+        {
+            inline constexpr size_t kCacheLineSize = 64;
+            inline constexpr size_t kParallelChunkBytes = 64 * 1024;
+
+            // smallest number of elements spanning whole cache lines
+            template <typename T>
+            constexpr size_t GetLineElements() { return kCacheLineSize / std::gcd(kCacheLineSize, sizeof(T)); }
+
+            template <typename T>
+            constexpr size_t GetChunkElements()
+            {
+                constexpr size_t kLine = GetLineElements<T>();
+                return std::max(kLine, kParallelChunkBytes / sizeof(T) / kLine * kLine);
+            }
+
+            inline size_t GetChunkCount(size_t count, size_t chunk) { return (count + chunk - 1) / chunk; }
+        }
+
+        /// calls function(y, row) for each row, with row a std::span over the row elements. Rows are handed out in
+        /// bands whose size is a whole number of cache lines, padded layouts included.
+        template <typename T, typename Layout, typename Allocator, typename Function> requires Layout::kHasContiguousRows
+        void ParallelForEachRow(Matrix<T, Layout, Allocator>& matrix, const Function& function, ThreadPool& pool = ThreadPool::GetDefault())
+        {
+            const MatrixView<T> view = matrix.AsView();
+            if (view.GetSizeX() == 0 || view.GetSizeY() == 0)
+                return;
+
+            const size_t stride = view.GetRowStride();
+            const size_t unit = detail::GetLineElements<T>() / std::gcd(stride, detail::GetLineElements<T>());
+            const size_t wanted = (detail::GetChunkElements<T>() + stride - 1) / stride;
+            const size_t band = (wanted + unit - 1) / unit * unit;
+
+            pool.ParallelFor(detail::GetChunkCount(view.GetSizeY(), band), [&](size_t chunk)
+            {
+                const size_t end = std::min(view.GetSizeY(), (chunk + 1) * band);
+                for (size_t y = chunk * band; y < end; ++y)
+                    function(y, view.Row(y));
+            });
+        }
+
+        /// out[i] = function(a[i]) for every element, out is resized to a and may be a
+        template <typename T, typename U, typename Layout, typename Allocator, typename OutAllocator, typename Function> requires Layout::kIsRowMajor
+        void ParallelTransform(const Matrix<T, Layout, Allocator>& a, Matrix<U, Layout, OutAllocator>& out, const Function& function,
+                               ThreadPool& pool = ThreadPool::GetDefault())
+        {
+            if (out.GetSizeX() != a.GetSizeX() || out.GetSizeY() != a.GetSizeY())
+            {
+                out.Clear();
+                out.ResizeUninitialized(a.GetSizeX(), a.GetSizeY());
+            }
+
+            const size_t count = a.GetSizeX() * a.GetSizeY();
+            const size_t chunk_elements = detail::GetChunkElements<U>();
+            const T* input = a.GetData();
+            U* output = out.GetData();
+
+            pool.ParallelFor(detail::GetChunkCount(count, chunk_elements), [&](size_t chunk)
+            {
+                const size_t end = std::min(count, (chunk + 1) * chunk_elements);
+                for (size_t i = chunk * chunk_elements; i < end; ++i)
+                    output[i] = function(input[i]);
+            });
+        }
+
+        /// folds the elements with op(R, T), each chunk starting from identity, then folds the chunk results in order
+        /// with op(R, R). Floating point sums are rounded the same way on any number of threads.
+        template <typename T, typename Layout, typename Allocator, typename R, typename Op> requires Layout::kIsRowMajor
+        R ParallelReduce(const Matrix<T, Layout, Allocator>& a, R identity, const Op& op, ThreadPool& pool = ThreadPool::GetDefault())
+        {
+            const size_t count = a.GetSizeX() * a.GetSizeY();
+            const size_t chunk_elements = detail::GetChunkElements<T>();
+            const T* input = a.GetData();
+
+            // one cache line per chunk result: no false sharing, and no packed std::vector<bool> words written by
+            // several threads
+            struct alignas(64) Partial
+            {
+                R value;
+            };
+
+            std::vector<Partial> partials(detail::GetChunkCount(count, chunk_elements), Partial { identity });
+            pool.ParallelFor(partials.size(), [&](size_t chunk)
+            {
+                const size_t end = std::min(count, (chunk + 1) * chunk_elements);
+                R accumulator = identity;
+                for (size_t i = chunk * chunk_elements; i < end; ++i)
+                    accumulator = op(accumulator, input[i]);
+                partials[chunk].value = accumulator;
+            });
+
+            R result = identity;
+            for (const Partial& partial : partials)
+                result = op(result, partial.value);
+            return result;
+        }
+    }
+}
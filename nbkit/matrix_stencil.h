@@ -0,0 +1,335 @@
+#pragma once
+
+#include "nbkit/fixed_matrix.h"
+#include "nbkit/matrix_ops.h"
+#include "nbkit/matrix_parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nbkit
+{
+    /// how stencils read the cells beyond the matrix edges: the nearest edge cell, the opposite side, or zero
+    enum class EdgePolicy { kClamp, kWrap, kZero };
+
+    /// <summary>
+    /// Convolutions and stencils over matrices with contiguous rows, with a kernel size known at compile time and
+    /// anchored at (KernelWidth / 2, KernelHeight / 2). Each output row is computed from a window of KernelHeight
+    /// prepared rows sliding down the matrix: copies of the input rows padded by the edge policy, so the inner loops
+    /// have no edge checks and each input row is copied once. As the window holds copies, out may be the input.
+    ///  - Convolve weights the window with a FixedMatrix kernel, one SIMD ScaleAdd over the row per non-zero tap.
+    ///    Kernels that are an outer product (box, binomial, Sobel...) run as a horizontal pass while rows are
+    ///    prepared then a vertical pass, KernelWidth + KernelHeight taps instead of their product; floating point
+    ///    results may then differ in the last bits from the direct sum.
+    ///  - Stencil calls a function on the window of each cell, for rules that aren't weighted sums (game of life...)
+    ///  - the Parallel versions cut the rows in bands run on a ThreadPool and give the same results. In place, they
+    ///    fill a second matrix that then replaces the input (double buffering).
+    /// </summary>
+    namespace matrix_ops
+    {
+        /// cells around the one being computed, Get(0, 0) is the cell itself
+        template <typename T, size_t KernelWidth, size_t KernelHeight>
+        class StencilWindow
+        {
+        private:
+            const T* const* rows_;
+            size_t x_;
+
+        public:
+            static constexpr std::ptrdiff_t kLeft = KernelWidth / 2;
+            static constexpr std::ptrdiff_t kTop = KernelHeight / 2;
+
+            StencilWindow(const T* const* rows, size_t x) : rows_(rows), x_(x) {}
+
+            /// dx in [-kLeft, KernelWidth - 1 - kLeft], dy in [-kTop, KernelHeight - 1 - kTop]
+            const T& Get(std::ptrdiff_t dx, std::ptrdiff_t dy) const
+            {
+                return rows_[dy + kTop][static_cast<std::ptrdiff_t>(x_) + kLeft + dx];
+            }
+        };
+
+        namespace detail
+        {
+            inline constexpr size_t kStencilOutside = SIZE_MAX;
+
+            // row or column read for position i of a size long axis, kStencilOutside when it reads zero
+            template <EdgePolicy Edge>
+            size_t MapEdge(std::ptrdiff_t i, size_t size)
+            {
+                const auto n = static_cast<std::ptrdiff_t>(size);
+                if constexpr (Edge == EdgePolicy::kClamp)
+                    return static_cast<size_t>(std::clamp<std::ptrdiff_t>(i, 0, n - 1));
+                else if constexpr (Edge == EdgePolicy::kWrap)
+                    return static_cast<size_t>((i % n + n) % n);
+                else
+                    return i < 0 || i >= n ? kStencilOutside : static_cast<size_t>(i);
+            }
+
+            // row preceded by left cells and followed by right cells, filled by the edge policy
+            template <EdgePolicy Edge, typename T>
+            void PadRow(const T* row, size_t width, size_t left, size_t right, T* padded)
+            {
+                std::copy(row, row + width, padded + left);
+                for (size_t i = 0; i < left; ++i)
+                {
+                    const size_t x = MapEdge<Edge>(static_cast<std::ptrdiff_t>(i) - static_cast<std::ptrdiff_t>(left), width);
+                    padded[i] = x == kStencilOutside ? T {} : row[x];
+                }
+                for (size_t i = 0; i < right; ++i)
+                {
+                    const size_t x = MapEdge<Edge>(static_cast<std::ptrdiff_t>(width + i), width);
+                    padded[left + width + i] = x == kStencilOutside ? T {} : row[x];
+                }
+            }
+
+            // out = sum of weights[k] * sources[k] over row_size elements, zero weights skipped
+            template <typename T, size_t Count>
+            void WeightRows(const std::array<const T*, Count>& sources, const std::array<T, Count>& weights, T* out, size_t size)
+            {
+                bool first = true;
+                for (size_t k = 0; k < Count; ++k)
+                {
+                    if (weights[k] == T {})
+                        continue;
+                    if (first)
+                        simd::Scale(sources[k], weights[k], out, size);
+                    else
+                        simd::ScaleAdd(sources[k], weights[k], out, out, size);
+                    first = false;
+                }
+                if (first)
+                    std::fill(out, out + size, T {});
+            }
+
+            // calls emit(y, rows) for y in [begin, end), rows[k] pointing at the prepared input row y + k - top, or at a
+            // zero row when it is outside and the edges are zero. prepare(y, destination) writes the prepared row y.
+            // The window slides down: the slot of the row leaving at the top gets the row entering below.
+            // With keep_first_rows (wrapping in place), the first rows are prepared up front, as they are overwritten
+            // before the bottom of the matrix wraps around to them.
+            template <EdgePolicy Edge, size_t KernelHeight, typename T, typename Prepare, typename Emit>
+            void SlideRows(size_t height, size_t begin, size_t end, size_t row_size, bool keep_first_rows,
+                           const Prepare& prepare, const Emit& emit)
+            {
+                constexpr std::ptrdiff_t kTop = KernelHeight / 2;
+                constexpr size_t kBottom = KernelHeight - 1 - KernelHeight / 2;
+
+                // KernelHeight slots, then the zero row, then the kept first rows
+                const size_t kept = keep_first_rows ? std::min(kBottom, height) : 0;
+                std::vector<T> buffer((KernelHeight + 1 + kept) * row_size, T {});
+                const T* zero = buffer.data() + KernelHeight * row_size;
+                T* first_rows = buffer.data() + (KernelHeight + 1) * row_size;
+                for (size_t y = 0; y < kept; ++y)
+                    prepare(y, first_rows + y * row_size);
+
+                const auto load = [&](size_t slot, std::ptrdiff_t y) -> const T*
+                {
+                    const size_t source = MapEdge<Edge>(y, height);
+                    if (source == kStencilOutside)
+                        return zero;
+                    if (y >= static_cast<std::ptrdiff_t>(height) && source < kept)
+                        return first_rows + source * row_size;
+                    T* destination = buffer.data() + slot * row_size;
+                    prepare(source, destination);
+                    return destination;
+                };
+
+                std::array<const T*, KernelHeight> rows;
+                for (size_t k = 0; k < KernelHeight; ++k)
+                    rows[k] = load(k, static_cast<std::ptrdiff_t>(begin + k) - kTop);
+
+                for (size_t y = begin; y < end; ++y)
+                {
+                    if (y > begin)
+                    {
+                        std::rotate(rows.begin(), rows.begin() + 1, rows.end());
+                        rows.back() = load((y - begin - 1) % KernelHeight, static_cast<std::ptrdiff_t>(y + kBottom));
+                    }
+                    emit(y, rows);
+                }
+            }
+
+            // kernel = column * row when it is an outer product worth splitting
+            template <typename T, size_t KernelWidth, size_t KernelHeight>
+            bool FactorKernel(const FixedMatrix<T, KernelWidth, KernelHeight>& kernel, std::array<T, KernelWidth>& row,
+                              std::array<T, KernelHeight>& column)
+            {
+                if constexpr (KernelWidth == 1 || KernelHeight == 1)
+                    return false;
+
+                const T* pivot = std::find_if(kernel.begin(), kernel.end(), [](const T& value) { return !(value == T {}); });
+                if (pivot == kernel.end())
+                    return false;
+                const size_t pivot_x = static_cast<size_t>(pivot - kernel.begin()) % KernelWidth;
+                const size_t pivot_y = static_cast<size_t>(pivot - kernel.begin()) / KernelWidth;
+
+                for (size_t x = 0; x < KernelWidth; ++x)
+                    row[x] = kernel.Get(x, pivot_y);
+                for (size_t y = 0; y < KernelHeight; ++y)
+                    column[y] = kernel.Get(pivot_x, y) / *pivot;
+
+                for (size_t y = 0; y < KernelHeight; ++y)
+                    for (size_t x = 0; x < KernelWidth; ++x)
+                        if (!(column[y] * row[x] == kernel.Get(x, y)))
+                            return false;
+                return true;
+            }
+
+            template <EdgePolicy Edge, typename T, typename Layout, typename Allocator, size_t KernelWidth, size_t KernelHeight>
+            void ConvolveRows(const Matrix<T, Layout, Allocator>& in, const FixedMatrix<T, KernelWidth, KernelHeight>& kernel,
+                              Matrix<T, Layout, Allocator>& out, size_t begin, size_t end)
+            {
+                constexpr size_t kLeft = KernelWidth / 2;
+                constexpr size_t kRight = KernelWidth - 1 - kLeft;
+                const size_t width = in.GetSizeX();
+                const size_t height = in.GetSizeY();
+                const bool keep_first_rows = Edge == EdgePolicy::kWrap && &in == &out;
+
+                std::array<T, KernelWidth> row_weights;
+                std::array<T, KernelHeight> column_weights;
+                std::vector<T> padded(width + KernelWidth - 1);
+
+                if (FactorKernel(kernel, row_weights, column_weights))
+                {
+                    // prepared rows are filtered horizontally, the window only weights them vertically
+                    const auto prepare = [&](size_t y, T* destination)
+                    {
+                        PadRow<Edge>(in.RowPtr(y), width, kLeft, kRight, padded.data());
+                        std::array<const T*, KernelWidth> taps;
+                        for (size_t x = 0; x < KernelWidth; ++x)
+                            taps[x] = padded.data() + x;
+                        WeightRows(taps, row_weights, destination, width);
+                    };
+                    const auto emit = [&](size_t y, const std::array<const T*, KernelHeight>& rows)
+                    {
+                        WeightRows(rows, column_weights, out.RowPtr(y), width);
+                    };
+                    SlideRows<Edge, KernelHeight, T>(height, begin, end, width, keep_first_rows, prepare, emit);
+                    return;
+                }
+
+                std::array<T, KernelWidth * KernelHeight> weights;
+                std::copy(kernel.begin(), kernel.end(), weights.begin());
+                const auto prepare = [&](size_t y, T* destination) { PadRow<Edge>(in.RowPtr(y), width, kLeft, kRight, destination); };
+                const auto emit = [&](size_t y, const std::array<const T*, KernelHeight>& rows)
+                {
+                    std::array<const T*, KernelWidth * KernelHeight> taps;
+                    for (size_t k = 0; k < KernelHeight; ++k)
+                        for (size_t x = 0; x < KernelWidth; ++x)
+                            taps[k * KernelWidth + x] = rows[k] + x;
+                    WeightRows(taps, weights, out.RowPtr(y), width);
+                };
+                SlideRows<Edge, KernelHeight, T>(height, begin, end, width + KernelWidth - 1, keep_first_rows, prepare, emit);
+            }
+
+            template <size_t KernelWidth, size_t KernelHeight, EdgePolicy Edge, typename T, typename Layout, typename Allocator, typename Function>
+            void StencilRows(const Matrix<T, Layout, Allocator>& in, Matrix<T, Layout, Allocator>& out, const Function& function,
+                             size_t begin, size_t end)
+            {
+                constexpr size_t kLeft = KernelWidth / 2;
+                constexpr size_t kRight = KernelWidth - 1 - kLeft;
+                const size_t width = in.GetSizeX();
+
+                const auto prepare = [&](size_t y, T* destination) { PadRow<Edge>(in.RowPtr(y), width, kLeft, kRight, destination); };
+                const auto emit = [&](size_t y, const std::array<const T*, KernelHeight>& rows)
+                {
+                    T* out_row = out.RowPtr(y);
+                    for (size_t x = 0; x < width; ++x)
+                        out_row[x] = function(StencilWindow<T, KernelWidth, KernelHeight>(rows.data(), x));
+                };
+                SlideRows<Edge, KernelHeight, T>(in.GetSizeY(), begin, end, width + KernelWidth - 1,
+                                                 Edge == EdgePolicy::kWrap && &in == &out, prepare, emit);
+            }
+
+            // run(in, out, begin, end) over bands of rows; in place, the bands write a second matrix that replaces out
+            template <size_t KernelHeight, typename T, typename Layout, typename Allocator, typename Run>
+            void RunStencilBands(const Matrix<T, Layout, Allocator>& in, Matrix<T, Layout, Allocator>& out, ThreadPool& pool,
+                                 const Run& run)
+            {
+                const size_t width = in.GetSizeX();
+                const size_t height = in.GetSizeY();
+                if (width == 0 || height == 0)
+                {
+                    ResizeOutput(out, width, height);
+                    return;
+                }
+
+                // bands of about kParallelChunkBytes, high enough that re-preparing the window at each band stays cheap
+                const size_t band = std::max(4 * KernelHeight, (kParallelChunkBytes / sizeof(T) + width - 1) / width);
+                const auto run_bands = [&](Matrix<T, Layout, Allocator>& target)
+                {
+                    pool.ParallelFor(GetChunkCount(height, band), [&](size_t chunk)
+                    {
+                        run(in, target, chunk * band, std::min(height, (chunk + 1) * band));
+                    });
+                };
+
+                if (&out != &in)
+                {
+                    ResizeOutput(out, width, height);
+                    run_bands(out);
+                    return;
+                }
+
+                Matrix<T, Layout, Allocator> buffer(in.GetAllocator());
+                buffer.ResizeUninitialized(width, height);
+                run_bands(buffer);
+                out = std::move(buffer);
+            }
+        }
+
+        //------ convolution
+
+        /// out(x, y) = sum of kernel(i, j) * in(x + i - KernelWidth / 2, y + j - KernelHeight / 2), out may be in
+        template <EdgePolicy Edge = EdgePolicy::kClamp, typename T, typename Layout, typename Allocator, size_t KernelWidth, size_t KernelHeight>
+            requires Layout::kHasContiguousRows
+        void Convolve(const Matrix<T, Layout, Allocator>& in, const FixedMatrix<T, KernelWidth, KernelHeight>& kernel,
+                      Matrix<T, Layout, Allocator>& out)
+        {
+            if (&out != &in)
+                detail::ResizeOutput(out, in.GetSizeX(), in.GetSizeY());
+            if (in.GetSizeX() != 0 && in.GetSizeY() != 0)
+                detail::ConvolveRows<Edge>(in, kernel, out, 0, in.GetSizeY());
+        }
+
+        template <EdgePolicy Edge = EdgePolicy::kClamp, typename T, typename Layout, typename Allocator, size_t KernelWidth, size_t KernelHeight>
+            requires Layout::kHasContiguousRows
+        void ParallelConvolve(const Matrix<T, Layout, Allocator>& in, const FixedMatrix<T, KernelWidth, KernelHeight>& kernel,
+                              Matrix<T, Layout, Allocator>& out, ThreadPool& pool = ThreadPool::GetDefault())
+        {
+            detail::RunStencilBands<KernelHeight>(in, out, pool, [&](const auto& source, auto& target, size_t begin, size_t end)
+            {
+                detail::ConvolveRows<Edge>(source, kernel, target, begin, end);
+            });
+        }
+
+        //------ stencil
+
+        /// out(x, y) = function(window) with window a StencilWindow around (x, y), out may be in
+        template <size_t KernelWidth, size_t KernelHeight, EdgePolicy Edge = EdgePolicy::kClamp, typename T, typename Layout,
+                  typename Allocator, typename Function>
+            requires Layout::kHasContiguousRows
+        void Stencil(const Matrix<T, Layout, Allocator>& in, Matrix<T, Layout, Allocator>& out, const Function& function)
+        {
+            if (&out != &in)
+                detail::ResizeOutput(out, in.GetSizeX(), in.GetSizeY());
+            if (in.GetSizeX() != 0 && in.GetSizeY() != 0)
+                detail::StencilRows<KernelWidth, KernelHeight, Edge>(in, out, function, 0, in.GetSizeY());
+        }
+
+        template <size_t KernelWidth, size_t KernelHeight, EdgePolicy Edge = EdgePolicy::kClamp, typename T, typename Layout,
+                  typename Allocator, typename Function>
+            requires Layout::kHasContiguousRows
+        void ParallelStencil(const Matrix<T, Layout, Allocator>& in, Matrix<T, Layout, Allocator>& out, const Function& function,
+                             ThreadPool& pool = ThreadPool::GetDefault())
+        {
+            detail::RunStencilBands<KernelHeight>(in, out, pool, [&](const auto& source, auto& target, size_t begin, size_t end)
+            {
+                detail::StencilRows<KernelWidth, KernelHeight, Edge>(source, target, function, begin, end);
+            });
+        }
+    }
+}
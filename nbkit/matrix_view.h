@@ -0,0 +1,182 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Random access iterator moving by a fixed stride over contiguous memory, e.g. down a column of a row-major matrix
+    /// </summary>
+    template <typename T>
+    class StridedIterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+    private:
+        T* ptr_ = nullptr;
+        difference_type stride_ = 1;
+
+    public:
+        constexpr StridedIterator() = default;
+        constexpr StridedIterator(T* ptr, difference_type stride) : ptr_(ptr), stride_(stride) {}
+
+        constexpr reference operator*() const { return *ptr_; }
+        constexpr pointer operator->() const { return ptr_; }
+        constexpr StridedIterator& operator++() { ptr_ += stride_; return *this; }
+        constexpr StridedIterator operator++(int) { StridedIterator temp = *this; ptr_ += stride_; return temp; }
+        constexpr StridedIterator& operator--() { ptr_ -= stride_; return *this; }
+        constexpr StridedIterator operator--(int) { StridedIterator temp = *this; ptr_ -= stride_; return temp; }
+        constexpr StridedIterator operator+(difference_type n) const { return StridedIterator(ptr_ + n * stride_, stride_); }
+        constexpr StridedIterator operator-(difference_type n) const { return StridedIterator(ptr_ - n * stride_, stride_); }
+        friend constexpr StridedIterator operator+(difference_type n, const StridedIterator& it) { return it + n; }
+        constexpr StridedIterator& operator+=(difference_type n) { ptr_ += n * stride_; return *this; }
+        constexpr StridedIterator& operator-=(difference_type n) { ptr_ -= n * stride_; return *this; }
+        constexpr difference_type operator-(const StridedIterator& other) const { return (ptr_ - other.ptr_) / stride_; }
+        constexpr bool operator==(const StridedIterator& other) const { return ptr_ == other.ptr_; }
+        constexpr auto operator<=>(const StridedIterator& other) const { return stride_ > 0 ? ptr_ <=> other.ptr_ : other.ptr_ <=> ptr_; }
+        constexpr reference operator[](difference_type n) const { return ptr_[n * stride_]; }
+    };
+
+    /// <summary>
+    /// Non-owning sequence of size elements spaced by stride, a column of a matrix for instance
+    /// </summary>
+    template <typename T>
+    class StridedSpan
+    {
+        // -------------------------------------------------------------------- fields
+    private:
+        T* data_ = nullptr;
+        size_t size_ = 0;
+        size_t stride_ = 1;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        constexpr StridedSpan() = default;
+        constexpr StridedSpan(T* data, size_t size, size_t stride) : data_(data), size_(size), stride_(stride) {}
+
+        constexpr T* GetData() const { return data_; }
+        constexpr size_t GetSize() const { return size_; }
+        constexpr size_t GetStride() const { return stride_; }
+        constexpr bool IsContiguous() const { return stride_ == 1; }
+
+        /// only valid when IsContiguous
+        constexpr std::span<T> AsSpan() const { return std::span<T>(data_, size_); }
+
+        constexpr T& operator[](size_t i) const { return data_[i * stride_]; }
+
+        constexpr StridedIterator<T> begin() const { return StridedIterator<T>(data_, static_cast<std::ptrdiff_t>(stride_)); }
+        constexpr StridedIterator<T> end() const { return begin() + static_cast<std::ptrdiff_t>(size_); }
+        constexpr size_t size() const { return size_; }
+    };
+
+    /// <summary>
+    /// Non-owning rectangular region of a row-major buffer: rows are contiguous and start row_stride elements apart.
+    /// Rows are exposed as std::span, columns as StridedSpan, iterators walk the region row by row.
+    /// </summary>
+    template <typename T>
+    class MatrixView
+    {
+        // -------------------------------------------------------------------- fields
+    private:
+        T* data_ = nullptr;
+        size_t width_ = 0;
+        size_t height_ = 0;
+        size_t row_stride_ = 0;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        constexpr MatrixView() = default;
+        constexpr MatrixView(T* data, size_t width, size_t height, size_t row_stride)
+            : data_(data), width_(width), height_(height), row_stride_(row_stride) {}
+
+        constexpr size_t GetSizeX() const { return width_; }
+        constexpr size_t GetSizeY() const { return height_; }
+        constexpr size_t GetRowStride() const { return row_stride_; }
+        constexpr T* GetData() const { return data_; }
+
+        /// true when rows follow each other with no gap, so the whole region is one span
+        constexpr bool IsContiguous() const { return width_ == row_stride_ || height_ <= 1; }
+
+        constexpr T& Get(size_t x, size_t y) const { return data_[row_stride_ * y + x]; }
+
+        constexpr std::span<T> Row(size_t y) const { return std::span<T>(data_ + row_stride_ * y, width_); }
+        constexpr StridedSpan<T> Col(size_t x) const { return StridedSpan<T>(data_ + x, height_, row_stride_); }
+
+        constexpr MatrixView SubMatrix(size_t x, size_t y, size_t width, size_t height) const
+        {
+            return MatrixView(data_ + row_stride_ * y + x, width, height, row_stride_);
+        }
+
+        // -------------------------------------------------------------------- iterator
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using iterator_concept = std::random_access_iterator_tag;
+            using value_type = std::remove_cv_t<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+        private:
+            T* data_ = nullptr;
+            size_t width_ = 0;
+            size_t row_stride_ = 0;
+            size_t x_ = 0;
+            size_t y_ = 0;
+
+        public:
+            constexpr Iterator() = default;
+            constexpr Iterator(const MatrixView& view, size_t index) : data_(view.data_), width_(view.width_), row_stride_(view.row_stride_)
+            {
+                SetIndex(index);
+            }
+
+            constexpr reference operator*() const { return data_[row_stride_ * y_ + x_]; }
+            constexpr pointer operator->() const { return &data_[row_stride_ * y_ + x_]; }
+            constexpr Iterator& operator++() { if (++x_ == width_) { x_ = 0; ++y_; } return *this; }
+            constexpr Iterator operator++(int) { Iterator temp = *this; ++*this; return temp; }
+            constexpr Iterator& operator--() { if (x_-- == 0) { x_ = width_ - 1; --y_; } return *this; }
+            constexpr Iterator operator--(int) { Iterator temp = *this; --*this; return temp; }
+            constexpr Iterator operator+(difference_type n) const { Iterator temp = *this; temp.SetIndex(GetIndex() + n); return temp; }
+            constexpr Iterator operator-(difference_type n) const { Iterator temp = *this; temp.SetIndex(GetIndex() - n); return temp; }
+            friend constexpr Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+            constexpr Iterator& operator+=(difference_type n) { SetIndex(GetIndex() + n); return *this; }
+            constexpr Iterator& operator-=(difference_type n) { SetIndex(GetIndex() - n); return *this; }
+            constexpr difference_type operator-(const Iterator& other) const { return static_cast<difference_type>(GetIndex() - other.GetIndex()); }
+            constexpr bool operator==(const Iterator& other) const { return x_ == other.x_ && y_ == other.y_; }
+            constexpr auto operator<=>(const Iterator& other) const { return GetIndex() <=> other.GetIndex(); }
+            constexpr reference operator[](difference_type n) const { return *(*this + n); }
+
+        private:
+            constexpr size_t GetIndex() const { return y_ * width_ + x_; }
+
+            constexpr void SetIndex(size_t index)
+            {
+                x_ = width_ == 0 ? 0 : index % width_;
+                y_ = width_ == 0 ? 0 : index / width_;
+            }
+        };
+
+        constexpr Iterator begin() const { return Iterator(*this, 0); }
+        constexpr Iterator end() const { return Iterator(*this, width_ * height_); }
+    };
+}
+
+// views don't own their elements, so iterators stay valid after the view itself is gone
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<nbkit::StridedSpan<T>> = true;
+
+template <typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<nbkit::MatrixView<T>> = true;
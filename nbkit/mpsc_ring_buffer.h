@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Bounded lock-free queue for many producers and a single consumer.
+    /// Each cell carries a sequence number telling whether it is free or holds a value (Vyukov scheme),
+    /// so producers only contend on the enqueue index and the consumer never takes a lock.
+    /// </summary>
+    template <typename T, size_t Capacity>
+    class MpscRingBuffer
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        // -------------------------------------------------------------------- fields
+    private:
+        static constexpr size_t kMask = Capacity - 1;
+        static constexpr size_t kCacheLineSize = 64;
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_ { 0 };
+        alignas(kCacheLineSize) size_t dequeue_pos_ = 0;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        MpscRingBuffer() : cells_(new Cell[Capacity])
+        {
+            for (size_t i = 0; i < Capacity; ++i)
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscRingBuffer(const MpscRingBuffer&) = delete;
+        MpscRingBuffer& operator = (const MpscRingBuffer&) = delete;
+
+        static constexpr size_t GetCapacity() { return Capacity; }
+
+        /// returns false if the queue is full, safe to call from any thread
+        bool TryPush(const T& value)
+        {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+
+            for (;;)
+            {
+                cell = &cells_[pos & kMask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = value;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// returns false if the queue is empty, must only be called from the consumer thread
+        bool TryPop(T& out)
+        {
+            Cell& cell = cells_[dequeue_pos_ & kMask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeue_pos_ + 1) < 0)
+                return false;
+
+            out = std::move(cell.value);
+            cell.sequence.store(dequeue_pos_ + Capacity, std::memory_order_release);
+            ++dequeue_pos_;
+            return true;
+        }
+    };
+}
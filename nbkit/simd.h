@@ -0,0 +1,483 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define NBKIT_SIMD_X86
+    #include <immintrin.h>
+#elif defined(_M_X64) && defined(_MSC_VER)
+    #define NBKIT_SIMD_X86
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
+
+namespace nbkit::simd
+{
+    /// <summary>
+    /// Elementwise and reduction kernels over raw arrays, with SSE2 / AVX2 / AVX-512 versions picked at runtime.
+    /// float and int32_t use explicit SIMD, any other arithmetic type goes through the scalar kernels.
+    ///  - every level gives bit identical results: reductions use a fixed order, MultiplyAdd is always fused and the
+    ///    products of Dot never are (GCC contraction is turned off for the kernels)
+    ///  - except Multiply, which accumulates with FMA where the level has it (AVX2 and up) and may differ in the last bits
+    ///  - Min, Max and Clamp follow the x86 minps / maxps rule: when a NaN is compared, the second operand wins
+    ///  - int32_t arithmetic wraps around
+    /// </summary>
+    enum class SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+    namespace detail
+    {
+        inline constexpr size_t kReductionLanes = 32;
+
+        // Multiply tiles are kMultiplyRows x (kMultiplyVectors * vector width), 12 accumulators fit the 16 registers of
+        // SSE2 / AVX2 next to the b values. Blocks keep packed a (96 x 256) in L2 and packed b (256 x 2048) in L3.
+        inline constexpr size_t kMultiplyRows = 6;
+        inline constexpr size_t kMultiplyVectors = 2;
+        inline constexpr size_t kMultiplyRowBlock = 96;
+        inline constexpr size_t kMultiplyDepthBlock = 256;
+        inline constexpr size_t kMultiplyColumnBlock = 2048;
+
+        inline SimdLevel DetectSimdLevel()
+        {
+#if defined(NBKIT_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            const bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+            const unsigned long long xcr0 = os_saves_avx ? _xgetbv(0) : 0;
+
+            __cpuidex(info, 7, 0);
+            const bool avx2 = (info[1] & (1 << 5)) != 0;
+            const bool avx512f = (info[1] & (1 << 16)) != 0;
+
+            if (avx512f && avx2 && fma && (xcr0 & 0xE6) == 0xE6)
+                return SimdLevel::kAvx512;
+            if (avx2 && fma && (xcr0 & 0x6) == 0x6)
+                return SimdLevel::kAvx2;
+            return sse2 ? SimdLevel::kSse2 : SimdLevel::kScalar;
+#elif defined(NBKIT_SIMD_X86)
+            __builtin_cpu_init();
+            const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            if (avx2 && __builtin_cpu_supports("avx512f"))
+                return SimdLevel::kAvx512;
+            if (avx2)
+                return SimdLevel::kAvx2;
+            return __builtin_cpu_supports("sse2") ? SimdLevel::kSse2 : SimdLevel::kScalar;
+#else
+            return SimdLevel::kScalar;
+#endif
+        }
+    }
+
+    /// best level the cpu supports
+    inline SimdLevel GetSupportedSimdLevel()
+    {
+        static const SimdLevel level = detail::DetectSimdLevel();
+        return level;
+    }
+
+    namespace detail
+    {
+        inline std::atomic<SimdLevel>& GetSimdLevelSlot()
+        {
+            static std::atomic<SimdLevel> level { GetSupportedSimdLevel() };
+            return level;
+        }
+    }
+
+    /// level used by the kernels, the supported one unless changed with SetSimdLevel
+    inline SimdLevel GetSimdLevel() { return detail::GetSimdLevelSlot().load(std::memory_order_relaxed); }
+
+    /// forces a lower level (e.g. to compare results or benchmark), capped to the supported one, returns the level set
+    inline SimdLevel SetSimdLevel(SimdLevel level)
+    {
+        const SimdLevel applied = static_cast<int>(level) < static_cast<int>(GetSupportedSimdLevel()) ? level : GetSupportedSimdLevel();
+        detail::GetSimdLevelSlot().store(applied, std::memory_order_relaxed);
+        return applied;
+    }
+
+    namespace detail
+    {
+// GCC contracts a * b + c into an FMA whenever the target has one (-ffp-contract=fast is its default in C++), which
+// would make Dot depend on the level. Clang and MSVC only contract within a single expression, which the kernels avoid.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC push_options
+    #pragma GCC optimize("fp-contract=off")
+#endif
+
+        //------ scalar operations, also used for the tails of vector loops
+
+        template <typename T>
+        struct ScalarOps
+        {
+            using Scalar = T;
+            using V = T;
+            static constexpr size_t kWidth = 1;
+            static constexpr bool kHasFma = false;
+
+            static constexpr T kMinIdentity = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+            static constexpr T kMaxIdentity = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+
+            static T Load(const T* p) { return *p; }
+            static void Store(T* p, T v) { *p = v; }
+            static T Set1(T v) { return v; }
+
+            static T Add(T a, T b)
+            {
+                if constexpr (std::is_integral_v<T>)
+                    return static_cast<T>(static_cast<std::make_unsigned_t<T>>(a) + static_cast<std::make_unsigned_t<T>>(b));
+                else
+                    return a + b;
+            }
+
+            static T Mul(T a, T b)
+            {
+                if constexpr (std::is_integral_v<T>)
+                    return static_cast<T>(static_cast<std::make_unsigned_t<T>>(a) * static_cast<std::make_unsigned_t<T>>(b));
+                else
+                    return a * b;
+            }
+
+            static T MulAdd(T a, T b, T c)
+            {
+                if constexpr (std::is_floating_point_v<T>)
+                    return std::fma(a, b, c);
+                else
+                    return Add(Mul(a, b), c);
+            }
+
+            // same rule as minps / maxps: the second operand wins unless the comparison holds
+            static T Min(T a, T b) { return a < b ? a : b; }
+            static T Max(T a, T b) { return a > b ? a : b; }
+        };
+
+        // pairwise tree over the lanes, the same for every instruction set
+        template <typename T, typename Op>
+        T ReduceLanes(T* lanes, Op op)
+        {
+            for (size_t width = kReductionLanes / 2; width > 0; width /= 2)
+                for (size_t j = 0; j < width; ++j)
+                    lanes[j] = op(lanes[j], lanes[j + width]);
+            return lanes[0];
+        }
+
+        template <typename T>
+        inline constexpr bool kHasVectorOps = std::is_same_v<T, float> || std::is_same_v<T, int32_t>;
+
+        struct Scalar
+        {
+            template <typename T>
+            using Ops = ScalarOps<T>;
+
+#include "nbkit/simd_kernels.h"
+        };
+
+#ifdef NBKIT_SIMD_X86
+        //------ SSE2
+
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("sse2")
+#endif
+
+        struct Sse2FloatOps
+        {
+            using Scalar = float;
+            using V = __m128;
+            static constexpr size_t kWidth = 4;
+            static constexpr bool kHasFma = false;
+
+            static V Load(const float* p) { return _mm_loadu_ps(p); }
+            static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+            static V Set1(float v) { return _mm_set1_ps(v); }
+            static V Add(V a, V b) { return _mm_add_ps(a, b); }
+            static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+            static V Min(V a, V b) { return _mm_min_ps(a, b); }
+            static V Max(V a, V b) { return _mm_max_ps(a, b); }
+
+            // no FMA instruction before AVX2, std::fma keeps the single rounding
+            static V MulAdd(V a, V b, V c)
+            {
+                alignas(16) float va[4], vb[4], vc[4];
+                _mm_store_ps(va, a);
+                _mm_store_ps(vb, b);
+                _mm_store_ps(vc, c);
+                for (size_t j = 0; j < 4; ++j)
+                    va[j] = std::fma(va[j], vb[j], vc[j]);
+                return _mm_load_ps(va);
+            }
+        };
+
+        struct Sse2IntOps
+        {
+            using Scalar = int32_t;
+            using V = __m128i;
+            static constexpr size_t kWidth = 4;
+            static constexpr bool kHasFma = false;
+
+            static V Load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static void Store(int32_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+            static V Set1(int32_t v) { return _mm_set1_epi32(v); }
+            static V Add(V a, V b) { return _mm_add_epi32(a, b); }
+
+            // SSE2 only multiplies even lanes, the odd ones are shifted down and multiplied separately
+            static V Mul(V a, V b)
+            {
+                const __m128i even = _mm_mul_epu32(a, b);
+                const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+                return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            }
+
+            static V MulAdd(V a, V b, V c) { return Add(Mul(a, b), c); }
+
+            static V Min(V a, V b)
+            {
+                const __m128i a_smaller = _mm_cmplt_epi32(a, b);
+                return _mm_or_si128(_mm_and_si128(a_smaller, a), _mm_andnot_si128(a_smaller, b));
+            }
+
+            static V Max(V a, V b)
+            {
+                const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+                return _mm_or_si128(_mm_and_si128(a_greater, a), _mm_andnot_si128(a_greater, b));
+            }
+        };
+
+        struct Sse2
+        {
+            template <typename T>
+            using Ops = std::conditional_t<std::is_same_v<T, float>, Sse2FloatOps, Sse2IntOps>;
+
+#include "nbkit/simd_kernels.h"
+        };
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+        //------ AVX2
+
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx2,fma")
+#endif
+
+        struct Avx2FloatOps
+        {
+            using Scalar = float;
+            using V = __m256;
+            static constexpr size_t kWidth = 8;
+            static constexpr bool kHasFma = true;
+
+            static V Load(const float* p) { return _mm256_loadu_ps(p); }
+            static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+            static V Set1(float v) { return _mm256_set1_ps(v); }
+            static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+            static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+            static V MulAdd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+            static V Min(V a, V b) { return _mm256_min_ps(a, b); }
+            static V Max(V a, V b) { return _mm256_max_ps(a, b); }
+        };
+
+        struct Avx2IntOps
+        {
+            using Scalar = int32_t;
+            using V = __m256i;
+            static constexpr size_t kWidth = 8;
+            static constexpr bool kHasFma = false;
+
+            static V Load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static void Store(int32_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+            static V Set1(int32_t v) { return _mm256_set1_epi32(v); }
+            static V Add(V a, V b) { return _mm256_add_epi32(a, b); }
+            static V Mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+            static V MulAdd(V a, V b, V c) { return Add(Mul(a, b), c); }
+            static V Min(V a, V b) { return _mm256_min_epi32(a, b); }
+            static V Max(V a, V b) { return _mm256_max_epi32(a, b); }
+        };
+
+        struct Avx2
+        {
+            template <typename T>
+            using Ops = std::conditional_t<std::is_same_v<T, float>, Avx2FloatOps, Avx2IntOps>;
+
+#include "nbkit/simd_kernels.h"
+        };
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+        //------ AVX-512
+
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx512f,avx2,fma")
+#endif
+
+        struct Avx512FloatOps
+        {
+            using Scalar = float;
+            using V = __m512;
+            static constexpr size_t kWidth = 16;
+            static constexpr bool kHasFma = true;
+
+            static V Load(const float* p) { return _mm512_loadu_ps(p); }
+            static void Store(float* p, V v) { _mm512_storeu_ps(p, v); }
+            static V Set1(float v) { return _mm512_set1_ps(v); }
+            static V Add(V a, V b) { return _mm512_add_ps(a, b); }
+            static V Mul(V a, V b) { return _mm512_mul_ps(a, b); }
+            static V MulAdd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+
+            // the masked forms avoid _mm512_undefined_ps, which trips -Wmaybe-uninitialized on GCC 12
+            static V Min(V a, V b) { return _mm512_mask_min_ps(a, 0xFFFF, a, b); }
+            static V Max(V a, V b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); }
+        };
+
+        struct Avx512IntOps
+        {
+            using Scalar = int32_t;
+            using V = __m512i;
+            static constexpr size_t kWidth = 16;
+            static constexpr bool kHasFma = false;
+
+            static V Load(const int32_t* p) { return _mm512_loadu_si512(p); }
+            static void Store(int32_t* p, V v) { _mm512_storeu_si512(p, v); }
+            static V Set1(int32_t v) { return _mm512_set1_epi32(v); }
+            static V Add(V a, V b) { return _mm512_add_epi32(a, b); }
+            static V Mul(V a, V b) { return _mm512_mullo_epi32(a, b); }
+            static V MulAdd(V a, V b, V c) { return Add(Mul(a, b), c); }
+            static V Min(V a, V b) { return _mm512_mask_min_epi32(a, 0xFFFF, a, b); }
+            static V Max(V a, V b) { return _mm512_mask_max_epi32(a, 0xFFFF, a, b); }
+        };
+
+        struct Avx512
+        {
+            template <typename T>
+            using Ops = std::conditional_t<std::is_same_v<T, float>, Avx512FloatOps, Avx512IntOps>;
+
+#include "nbkit/simd_kernels.h"
+        };
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC pop_options
+#endif
+
+        /// calls call(Isa {}, Ops {}) with the kernels of the current level
+        template <typename T, typename Call>
+        decltype(auto) Dispatch(const Call& call)
+        {
+#ifdef NBKIT_SIMD_X86
+            if constexpr (kHasVectorOps<T>)
+            {
+                switch (GetSimdLevel())
+                {
+                    case SimdLevel::kAvx512: return call(Avx512 {}, Avx512::Ops<T> {});
+                    case SimdLevel::kAvx2:   return call(Avx2 {}, Avx2::Ops<T> {});
+                    case SimdLevel::kSse2:   return call(Sse2 {}, Sse2::Ops<T> {});
+                    case SimdLevel::kScalar: break;
+                }
+            }
+#endif
+            return call(Scalar {}, ScalarOps<T> {});
+        }
+    }
+
+    //------ elementwise, out may alias the inputs
+
+    /// out[i] = a[i] + b[i]
+    template <typename T>
+    void Add(const T* a, const T* b, T* out, size_t n)
+    {
+        detail::Dispatch<T>([&](auto isa, auto ops) { decltype(isa)::template Add<decltype(ops)>(a, b, out, n); });
+    }
+
+    /// out[i] = a[i] * factor
+    template <typename T>
+    void Scale(const T* a, T factor, T* out, size_t n)
+    {
+        detail::Dispatch<T>([&](auto isa, auto ops) { decltype(isa)::template Scale<decltype(ops)>(a, factor, out, n); });
+    }
+
+    /// out[i] = a[i] * factor + b[i], the product is rounded before the add (axpy, the step of convolutions)
+    template <typename T>
+    void ScaleAdd(const T* a, T factor, const T* b, T* out, size_t n)
+    {
+        detail::Dispatch<T>([&](auto isa, auto ops) { decltype(isa)::template ScaleAdd<decltype(ops)>(a, factor, b, out, n); });
+    }
+
+    /// out[i] = a[i] * b[i] + c[i], floating point values are rounded once (std::fma)
+    template <typename T>
+    void MultiplyAdd(const T* a, const T* b, const T* c, T* out, size_t n)
+    {
+        detail::Dispatch<T>([&](auto isa, auto ops) { decltype(isa)::template MultiplyAdd<decltype(ops)>(a, b, c, out, n); });
+    }
+
+    /// out[i] = min(max(a[i], low), high)
+    template <typename T>
+    void Clamp(const T* a, T low, T high, T* out, size_t n)
+    {
+        detail::Dispatch<T>([&](auto isa, auto ops) { decltype(isa)::template Clamp<decltype(ops)>(a, low, high, out, n); });
+    }
+
+    //------ reductions, Min / Max of an empty array return the identity (+inf / -inf, or the type limits)
+
+    template <typename T>
+    T Sum(const T* a, size_t n)
+    {
+        return detail::Dispatch<T>([&](auto isa, auto ops) { return decltype(isa)::template Sum<decltype(ops)>(a, n); });
+    }
+
+    template <typename T>
+    T Min(const T* a, size_t n)
+    {
+        return detail::Dispatch<T>([&](auto isa, auto ops) { return decltype(isa)::template Min<decltype(ops)>(a, n); });
+    }
+
+    template <typename T>
+    T Max(const T* a, size_t n)
+    {
+        return detail::Dispatch<T>([&](auto isa, auto ops) { return decltype(isa)::template Max<decltype(ops)>(a, n); });
+    }
+
+    /// sum of a[i] * b[i], each product rounded before being added
+    template <typename T>
+    T Dot(const T* a, const T* b, size_t n)
+    {
+        return detail::Dispatch<T>([&](auto isa, auto ops) { return decltype(isa)::template Dot<decltype(ops)>(a, b, n); });
+    }
+
+    //------ matrix product
+
+    /// out = a * b with a rows x depth, b depth x columns and out rows x columns, all row-major without padding.
+    /// out must not overlap a or b.
+    template <typename T>
+    void Multiply(const T* a, const T* b, T* out, size_t rows, size_t depth, size_t columns)
+    {
+        detail::Dispatch<T>([&](auto isa, auto ops) { decltype(isa)::template Multiply<decltype(ops)>(a, b, out, rows, depth, columns); });
+    }
+}
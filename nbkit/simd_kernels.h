@@ -0,0 +1,271 @@
+// Kernels shared by every instruction set. simd.h includes this file once per target, inside a struct compiled
+// for that target, with Ops giving the vector type and operations. No include guard on purpose.
+//
+// Reductions keep kReductionLanes independent partial results: lane j accumulates elements j, j + kReductionLanes...
+// whatever the vector width, then the tail and the final tree run through ScalarOps. This fixes the order of every
+// floating point operation, so all instruction sets give bit identical results.
+
+template <typename Ops>
+static void Add(const typename Ops::Scalar* a, const typename Ops::Scalar* b, typename Ops::Scalar* out, size_t n)
+{
+    using Tail = ScalarOps<typename Ops::Scalar>;
+
+    size_t i = 0;
+    for (; i + Ops::kWidth <= n; i += Ops::kWidth)
+        Ops::Store(out + i, Ops::Add(Ops::Load(a + i), Ops::Load(b + i)));
+    for (; i < n; ++i)
+        out[i] = Tail::Add(a[i], b[i]);
+}
+
+template <typename Ops>
+static void Scale(const typename Ops::Scalar* a, typename Ops::Scalar factor, typename Ops::Scalar* out, size_t n)
+{
+    using Tail = ScalarOps<typename Ops::Scalar>;
+
+    const auto factors = Ops::Set1(factor);
+    size_t i = 0;
+    for (; i + Ops::kWidth <= n; i += Ops::kWidth)
+        Ops::Store(out + i, Ops::Mul(Ops::Load(a + i), factors));
+    for (; i < n; ++i)
+        out[i] = Tail::Mul(a[i], factor);
+}
+
+// the product is rounded before the add, like Dot
+template <typename Ops>
+static void ScaleAdd(const typename Ops::Scalar* a, typename Ops::Scalar factor, const typename Ops::Scalar* b,
+                     typename Ops::Scalar* out, size_t n)
+{
+    using Tail = ScalarOps<typename Ops::Scalar>;
+
+    const auto factors = Ops::Set1(factor);
+    size_t i = 0;
+    for (; i + Ops::kWidth <= n; i += Ops::kWidth)
+        Ops::Store(out + i, Ops::Add(Ops::Mul(Ops::Load(a + i), factors), Ops::Load(b + i)));
+    for (; i < n; ++i)
+        out[i] = Tail::Add(Tail::Mul(a[i], factor), b[i]);
+}
+
+template <typename Ops>
+static void MultiplyAdd(const typename Ops::Scalar* a, const typename Ops::Scalar* b, const typename Ops::Scalar* c,
+                        typename Ops::Scalar* out, size_t n)
+{
+    using Tail = ScalarOps<typename Ops::Scalar>;
+
+    size_t i = 0;
+    for (; i + Ops::kWidth <= n; i += Ops::kWidth)
+        Ops::Store(out + i, Ops::MulAdd(Ops::Load(a + i), Ops::Load(b + i), Ops::Load(c + i)));
+    for (; i < n; ++i)
+        out[i] = Tail::MulAdd(a[i], b[i], c[i]);
+}
+
+template <typename Ops>
+static void Clamp(const typename Ops::Scalar* a, typename Ops::Scalar low, typename Ops::Scalar high,
+                  typename Ops::Scalar* out, size_t n)
+{
+    using Tail = ScalarOps<typename Ops::Scalar>;
+
+    const auto lows = Ops::Set1(low);
+    const auto highs = Ops::Set1(high);
+    size_t i = 0;
+    for (; i + Ops::kWidth <= n; i += Ops::kWidth)
+        Ops::Store(out + i, Ops::Min(Ops::Max(Ops::Load(a + i), lows), highs));
+    for (; i < n; ++i)
+        out[i] = Tail::Min(Tail::Max(a[i], low), high);
+}
+
+// Step(accumulator, i) folds the elements starting at index i into the accumulator
+template <typename Ops, typename Step>
+static void ReduceBlocks(typename Ops::Scalar identity, size_t n, typename Ops::Scalar* lanes, size_t& i, Step step)
+{
+    constexpr size_t kRegisters = kReductionLanes / Ops::kWidth;
+
+    typename Ops::V accumulators[kRegisters];
+    for (size_t r = 0; r < kRegisters; ++r)
+        accumulators[r] = Ops::Set1(identity);
+
+    for (; i + kReductionLanes <= n; i += kReductionLanes)
+        for (size_t r = 0; r < kRegisters; ++r)
+            accumulators[r] = step(accumulators[r], i + r * Ops::kWidth);
+
+    for (size_t r = 0; r < kRegisters; ++r)
+        Ops::Store(lanes + r * Ops::kWidth, accumulators[r]);
+}
+
+template <typename Ops>
+static typename Ops::Scalar Sum(const typename Ops::Scalar* a, size_t n)
+{
+    using T = typename Ops::Scalar;
+    using Tail = ScalarOps<T>;
+
+    T lanes[kReductionLanes];
+    size_t i = 0;
+    ReduceBlocks<Ops>(T {}, n, lanes, i, [a](auto acc, size_t index) { return Ops::Add(acc, Ops::Load(a + index)); });
+
+    for (size_t j = 0; i + j < n; ++j)
+        lanes[j] = Tail::Add(lanes[j], a[i + j]);
+    return ReduceLanes(lanes, [](T x, T y) { return Tail::Add(x, y); });
+}
+
+template <typename Ops>
+static typename Ops::Scalar Min(const typename Ops::Scalar* a, size_t n)
+{
+    using T = typename Ops::Scalar;
+    using Tail = ScalarOps<T>;
+
+    T lanes[kReductionLanes];
+    size_t i = 0;
+    ReduceBlocks<Ops>(Tail::kMinIdentity, n, lanes, i, [a](auto acc, size_t index) { return Ops::Min(acc, Ops::Load(a + index)); });
+
+    for (size_t j = 0; i + j < n; ++j)
+        lanes[j] = Tail::Min(lanes[j], a[i + j]);
+    return ReduceLanes(lanes, [](T x, T y) { return Tail::Min(x, y); });
+}
+
+template <typename Ops>
+static typename Ops::Scalar Max(const typename Ops::Scalar* a, size_t n)
+{
+    using T = typename Ops::Scalar;
+    using Tail = ScalarOps<T>;
+
+    T lanes[kReductionLanes];
+    size_t i = 0;
+    ReduceBlocks<Ops>(Tail::kMaxIdentity, n, lanes, i, [a](auto acc, size_t index) { return Ops::Max(acc, Ops::Load(a + index)); });
+
+    for (size_t j = 0; i + j < n; ++j)
+        lanes[j] = Tail::Max(lanes[j], a[i + j]);
+    return ReduceLanes(lanes, [](T x, T y) { return Tail::Max(x, y); });
+}
+
+// products are rounded before being added, like the scalar a[i] * b[i] + sum
+template <typename Ops>
+static typename Ops::Scalar Dot(const typename Ops::Scalar* a, const typename Ops::Scalar* b, size_t n)
+{
+    using T = typename Ops::Scalar;
+    using Tail = ScalarOps<T>;
+
+    T lanes[kReductionLanes];
+    size_t i = 0;
+    ReduceBlocks<Ops>(T {}, n, lanes, i, [a, b](auto acc, size_t index)
+    {
+        return Ops::Add(acc, Ops::Mul(Ops::Load(a + index), Ops::Load(b + index)));
+    });
+
+    for (size_t j = 0; i + j < n; ++j)
+        lanes[j] = Tail::Add(lanes[j], Tail::Mul(a[i + j], b[i + j]));
+    return ReduceLanes(lanes, [](T x, T y) { return Tail::Add(x, y); });
+}
+
+// c[kMultiplyRows x kColumns] += a_panel * b_panel over depth, then stores the rows and columns that exist.
+// a_panel holds kMultiplyRows values per depth step, b_panel kColumns values, both zero padded.
+template <typename Ops>
+static void MultiplyTile(const typename Ops::Scalar* a_panel, const typename Ops::Scalar* b_panel, size_t depth,
+                         typename Ops::Scalar* c, size_t c_stride, size_t rows, size_t columns)
+{
+    using T = typename Ops::Scalar;
+    constexpr size_t kWidth = Ops::kWidth;
+    constexpr size_t kColumns = kMultiplyVectors * kWidth;
+
+    typename Ops::V accumulators[kMultiplyRows][kMultiplyVectors];
+    for (size_t r = 0; r < kMultiplyRows; ++r)
+        for (size_t v = 0; v < kMultiplyVectors; ++v)
+            accumulators[r][v] = Ops::Set1(T {});
+
+    for (size_t k = 0; k < depth; ++k, a_panel += kMultiplyRows, b_panel += kColumns)
+    {
+        typename Ops::V b_values[kMultiplyVectors];
+        for (size_t v = 0; v < kMultiplyVectors; ++v)
+            b_values[v] = Ops::Load(b_panel + v * kWidth);
+
+        for (size_t r = 0; r < kMultiplyRows; ++r)
+        {
+            const auto a_value = Ops::Set1(a_panel[r]);
+            for (size_t v = 0; v < kMultiplyVectors; ++v)
+            {
+                if constexpr (Ops::kHasFma)
+                    accumulators[r][v] = Ops::MulAdd(a_value, b_values[v], accumulators[r][v]);
+                else
+                    accumulators[r][v] = Ops::Add(accumulators[r][v], Ops::Mul(a_value, b_values[v]));
+            }
+        }
+    }
+
+    if (columns == kColumns)
+    {
+        for (size_t r = 0; r < rows; ++r)
+            for (size_t v = 0; v < kMultiplyVectors; ++v)
+            {
+                T* destination = c + r * c_stride + v * kWidth;
+                Ops::Store(destination, Ops::Add(Ops::Load(destination), accumulators[r][v]));
+            }
+        return;
+    }
+
+    T tile[kColumns];
+    for (size_t r = 0; r < rows; ++r)
+    {
+        for (size_t v = 0; v < kMultiplyVectors; ++v)
+            Ops::Store(tile + v * kWidth, accumulators[r][v]);
+        for (size_t j = 0; j < columns; ++j)
+            c[r * c_stride + j] = ScalarOps<T>::Add(c[r * c_stride + j], tile[j]);
+    }
+}
+
+// out = a * b with a rows x depth, b depth x columns, all row-major. Goto style blocking: a depth slice of b is
+// packed for a column block and stays in L3, a block of a rows is packed and stays in L2, each tile walks one b
+// panel from L1 while the accumulators stay in registers.
+template <typename Ops>
+static void Multiply(const typename Ops::Scalar* a, const typename Ops::Scalar* b, typename Ops::Scalar* out,
+                     size_t rows, size_t depth, size_t columns)
+{
+    using T = typename Ops::Scalar;
+    constexpr size_t kColumns = kMultiplyVectors * Ops::kWidth;
+
+    std::fill(out, out + rows * columns, T {});
+    if (rows == 0 || depth == 0 || columns == 0)
+        return;
+
+    std::vector<T> packed_a(kMultiplyRowBlock * std::min(depth, kMultiplyDepthBlock));
+    std::vector<T> packed_b((std::min(columns, kMultiplyColumnBlock) + kColumns) * std::min(depth, kMultiplyDepthBlock));
+
+    for (size_t jc = 0; jc < columns; jc += kMultiplyColumnBlock)
+    {
+        const size_t nc = std::min(kMultiplyColumnBlock, columns - jc);
+
+        for (size_t pc = 0; pc < depth; pc += kMultiplyDepthBlock)
+        {
+            const size_t kc = std::min(kMultiplyDepthBlock, depth - pc);
+
+            for (size_t jr = 0; jr < nc; jr += kColumns)
+            {
+                T* panel = packed_b.data() + jr * kc;
+                const size_t width = std::min(kColumns, nc - jr);
+                for (size_t k = 0; k < kc; ++k, panel += kColumns)
+                {
+                    const T* source = b + (pc + k) * columns + jc + jr;
+                    for (size_t j = 0; j < kColumns; ++j)
+                        panel[j] = j < width ? source[j] : T {};
+                }
+            }
+
+            for (size_t ic = 0; ic < rows; ic += kMultiplyRowBlock)
+            {
+                const size_t mc = std::min(kMultiplyRowBlock, rows - ic);
+
+                for (size_t ir = 0; ir < mc; ir += kMultiplyRows)
+                {
+                    T* panel = packed_a.data() + ir * kc;
+                    const size_t height = std::min(kMultiplyRows, mc - ir);
+                    for (size_t k = 0; k < kc; ++k, panel += kMultiplyRows)
+                        for (size_t r = 0; r < kMultiplyRows; ++r)
+                            panel[r] = r < height ? a[(ic + ir + r) * depth + pc + k] : T {};
+                }
+
+                for (size_t jr = 0; jr < nc; jr += kColumns)
+                    for (size_t ir = 0; ir < mc; ir += kMultiplyRows)
+                        MultiplyTile<Ops>(packed_a.data() + ir * kc, packed_b.data() + jr * kc, kc,
+                                          out + (ic + ir) * columns + jc + jr, columns,
+                                          std::min(kMultiplyRows, mc - ir), std::min(kColumns, nc - jr));
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "nbkit/matrix.h"
+
+#include <type_traits>
+#include <tuple>
+#include <utility>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Structure-of-arrays matrix: a cell made of Fields... is stored as one row-major plane per field, so a pass over
+    /// a single field streams only that field and vectorizes like a Matrix of it. Get(x, y) returns a tuple of
+    /// references to the fields of the cell (usable with structured bindings or assigned a tuple), GetPlane<I>() gives
+    /// the Matrix holding field I with all its views and iterators.
+    /// </summary>
+    template <typename... Fields>
+    class SoaMatrix
+    {
+        static_assert(sizeof...(Fields) > 0, "SoaMatrix needs at least one field");
+        static_assert(!(std::is_same_v<Fields, bool> || ...), "bool planes would be std::vector<bool> bit sets, use uint8_t");
+
+        // -------------------------------------------------------------------- fields
+    private:
+        std::tuple<Matrix<Fields>...> planes_;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        static constexpr size_t kFieldCount = sizeof...(Fields);
+
+        template <size_t I>
+        using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+        using Reference = std::tuple<Fields&...>;
+        using ConstReference = std::tuple<const Fields&...>;
+
+        SoaMatrix() = default;
+        SoaMatrix(size_t width, size_t height) { Resize(width, height); }
+
+        size_t GetSizeX() const { return std::get<0>(planes_).GetSizeX(); }
+        size_t GetSizeY() const { return std::get<0>(planes_).GetSizeY(); }
+
+        /// elements keep their (x, y) position when they are still inside the matrix, new ones are value-initialized
+        void Resize(size_t width, size_t height)
+        {
+            ForEachPlane([&](auto& plane) { plane.Resize(width, height); });
+        }
+
+        void ReserveRows(size_t rows)
+        {
+            ForEachPlane([&](auto& plane) { plane.ReserveRows(rows); });
+        }
+
+        /// appends a row whose cells all hold values, on an empty matrix set the width first with Resize(width, 0)
+        void AppendRow(const Fields&... values)
+        {
+            AppendRow(std::index_sequence_for<Fields...>(), values...);
+        }
+
+        void Clear()
+        {
+            ForEachPlane([](auto& plane) { plane.Clear(); });
+        }
+
+        Reference Get(size_t x, size_t y)
+        {
+            return std::apply([&](auto&... plane) { return Reference(plane.Get(x, y)...); }, planes_);
+        }
+
+        ConstReference Get(size_t x, size_t y) const
+        {
+            return std::apply([&](const auto&... plane) { return ConstReference(plane.Get(x, y)...); }, planes_);
+        }
+
+        /// field I of cell (x, y)
+        template <size_t I>
+        FieldType<I>& Get(size_t x, size_t y) { return std::get<I>(planes_).Get(x, y); }
+
+        template <size_t I>
+        const FieldType<I>& Get(size_t x, size_t y) const { return std::get<I>(planes_).Get(x, y); }
+
+        /// matrix of field I; resizing it directly would break the other planes, resize the SoaMatrix instead
+        template <size_t I>
+        Matrix<FieldType<I>>& GetPlane() { return std::get<I>(planes_); }
+
+        template <size_t I>
+        const Matrix<FieldType<I>>& GetPlane() const { return std::get<I>(planes_); }
+
+    private:
+        template <typename Function>
+        void ForEachPlane(const Function& function)
+        {
+            std::apply([&](auto&... plane) { (function(plane), ...); }, planes_);
+        }
+
+        template <size_t... I>
+        void AppendRow(std::index_sequence<I...>, const Fields&... values)
+        {
+            (std::get<I>(planes_).EmplaceRow(values), ...);
+        }
+    };
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "nbkit/matrix.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Matrix for mostly empty grids: only the BlockSize x BlockSize blocks holding at least one set cell are
+    /// allocated, in a hash map keyed by block coordinates. Cells that were never set read as the default value.
+    /// Blocks keep neighbouring cells together, so stencils and row walks over populated areas hit the same block,
+    /// and ForEach visits only the set cells. Memory is about sizeof(Block) per populated block plus the map nodes.
+    /// </summary>
+    template <typename T, size_t BlockSize = 8>
+    class SparseMatrix
+    {
+        static_assert(std::has_single_bit(BlockSize) && BlockSize * BlockSize <= 64, "BlockSize must be a power of two up to 8");
+
+        // -------------------------------------------------------------------- fields
+    private:
+        static constexpr size_t kBlockShift = std::countr_zero(BlockSize);
+        static constexpr size_t kBlockMask = BlockSize - 1;
+
+        struct Block
+        {
+            std::array<T, BlockSize * BlockSize> cells;
+            uint64_t set_mask = 0;
+        };
+
+        size_t width_ = 0;
+        size_t height_ = 0;
+        T default_value_ {};
+        std::unordered_map<uint64_t, Block> blocks_;
+        size_t count_ = 0;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        SparseMatrix() = default;
+        SparseMatrix(size_t width, size_t height, const T& default_value = T())
+            : width_(width), height_(height), default_value_(default_value)
+        {
+            assert(width == 0 || height == 0 || IsInKeyRange(width - 1, height - 1));
+        }
+
+        /// copies the cells of a dense matrix that differ from default_value
+        template <typename Layout, typename Allocator>
+        static SparseMatrix FromMatrix(const Matrix<T, Layout, Allocator>& matrix, const T& default_value = T())
+        {
+            SparseMatrix sparse(matrix.GetSizeX(), matrix.GetSizeY(), default_value);
+            for (size_t y = 0; y < matrix.GetSizeY(); ++y)
+                for (size_t x = 0; x < matrix.GetSizeX(); ++x)
+                    if (!(matrix.Get(x, y) == default_value))
+                        sparse.Set(x, y, matrix.Get(x, y));
+            return sparse;
+        }
+
+        Matrix<T> ToMatrix() const
+        {
+            Matrix<T> matrix;
+            matrix.Resize(width_, height_);
+            std::fill(matrix.begin(), matrix.end(), default_value_);
+            ForEach([&](size_t x, size_t y, const T& value) { matrix.Get(x, y) = value; });
+            return matrix;
+        }
+
+        size_t GetSizeX() const { return width_; }
+        size_t GetSizeY() const { return height_; }
+        const T& GetDefaultValue() const { return default_value_; }
+
+        /// number of set cells
+        size_t GetCount() const { return count_; }
+        size_t GetBlockCount() const { return blocks_.size(); }
+
+        /// approximate heap usage: blocks, map nodes and buckets
+        size_t GetMemoryUsage() const
+        {
+            return blocks_.size() * (sizeof(Block) + sizeof(uint64_t) + 2 * sizeof(void*)) + blocks_.bucket_count() * sizeof(void*);
+        }
+
+        /// the set value, or the default value for a cell never set
+        const T& Get(size_t x, size_t y) const
+        {
+            assert(x < width_ && y < height_);
+            const auto it = blocks_.find(GetBlockKey(x, y));
+            if (it == blocks_.end() || (it->second.set_mask & GetCellBit(x, y)) == 0)
+                return default_value_;
+            return it->second.cells[GetCellIndex(x, y)];
+        }
+
+        bool IsSet(size_t x, size_t y) const
+        {
+            const auto it = blocks_.find(GetBlockKey(x, y));
+            return it != blocks_.end() && (it->second.set_mask & GetCellBit(x, y)) != 0;
+        }
+
+        void Set(size_t x, size_t y, const T& value) { GetOrCreate(x, y) = value; }
+
+        /// reference to the cell, set to the default value first if it wasn't set
+        T& GetOrCreate(size_t x, size_t y)
+        {
+            assert(x < width_ && y < height_);
+            auto [it, inserted] = blocks_.try_emplace(GetBlockKey(x, y));
+            Block& block = it->second;
+            if (inserted)
+                block.cells.fill(default_value_);
+
+            const uint64_t bit = GetCellBit(x, y);
+            if ((block.set_mask & bit) == 0)
+            {
+                block.set_mask |= bit;
+                ++count_;
+            }
+            return block.cells[GetCellIndex(x, y)];
+        }
+
+        /// the cell reads as the default value again, its block is freed with its last cell
+        void Erase(size_t x, size_t y)
+        {
+            const auto it = blocks_.find(GetBlockKey(x, y));
+            const uint64_t bit = GetCellBit(x, y);
+            if (it == blocks_.end() || (it->second.set_mask & bit) == 0)
+                return;
+
+            it->second.set_mask &= ~bit;
+            it->second.cells[GetCellIndex(x, y)] = default_value_;
+            --count_;
+            if (it->second.set_mask == 0)
+                blocks_.erase(it);
+        }
+
+        void Clear()
+        {
+            blocks_.clear();
+            count_ = 0;
+        }
+
+        /// calls function(x, y, value) for each set cell, blocks come in no particular order
+        template <typename Function>
+        void ForEach(const Function& function) const
+        {
+            for (const auto& [key, block] : blocks_)
+            {
+                const size_t x0 = static_cast<size_t>(key >> 32) << kBlockShift;
+                const size_t y0 = static_cast<size_t>(key & 0xFFFFFFFF) << kBlockShift;
+                for (uint64_t mask = block.set_mask; mask != 0; mask &= mask - 1)
+                {
+                    const size_t index = static_cast<size_t>(std::countr_zero(mask));
+                    function(x0 + (index & kBlockMask), y0 + (index >> kBlockShift), block.cells[index]);
+                }
+            }
+        }
+
+    private:
+        // block coordinates take 32 bits each, which covers grids of up to 2^32 blocks a side
+        static bool IsInKeyRange(size_t x, size_t y)
+        {
+            return static_cast<uint64_t>(x >> kBlockShift) <= UINT32_MAX && static_cast<uint64_t>(y >> kBlockShift) <= UINT32_MAX;
+        }
+
+        static uint64_t GetBlockKey(size_t x, size_t y)
+        {
+            assert(IsInKeyRange(x, y));
+            return (static_cast<uint64_t>(x >> kBlockShift) << 32) | static_cast<uint64_t>(y >> kBlockShift);
+        }
+
+        static size_t GetCellIndex(size_t x, size_t y) { return ((y & kBlockMask) << kBlockShift) | (x & kBlockMask); }
+        static uint64_t GetCellBit(size_t x, size_t y) { return uint64_t { 1 } << GetCellIndex(x, y); }
+    };
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Work-stealing pool running the iterations of ParallelFor. A task covers a range of iterations: the thread running
+    /// it keeps splitting off the second half into its own deque until one iteration is left, idle threads steal the
+    /// oldest (largest) ranges from the front of the other deques. The calling thread takes part, so a pool of
+    /// thread_count workers runs on thread_count + 1 cores and ParallelFor may be called from inside an iteration.
+    /// </summary>
+    class ThreadPool
+    {
+        // -------------------------------------------------------------------- fields
+    private:
+        static constexpr size_t kCacheLineSize = 64;
+
+        struct Job
+        {
+            void (*run)(const void* body, size_t index) = nullptr;
+            const void* body = nullptr;
+            std::atomic<size_t> remaining { 0 };
+        };
+
+        struct Task
+        {
+            Job* job = nullptr;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        // one per worker, plus a last one shared by the threads outside the pool
+        struct alignas(kCacheLineSize) Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::unique_ptr<Queue[]> queues_;
+        size_t queue_count_ = 0;
+        std::vector<std::thread> threads_;
+
+        // bumped on every push, idle workers wait for it to change
+        std::atomic<uint32_t> wake_epoch_ { 0 };
+        std::atomic<bool> stop_ { false };
+
+        static inline thread_local const ThreadPool* current_pool_ = nullptr;
+        static inline thread_local size_t current_queue_ = 0;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        /// the default leaves one core to the calling thread
+        explicit ThreadPool(size_t thread_count = GetDefaultThreadCount())
+            : queues_(new Queue[thread_count + 1]), queue_count_(thread_count + 1)
+        {
+            threads_.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; ++i)
+                threads_.emplace_back([this, i]() { Run(i); });
+        }
+
+        ~ThreadPool()
+        {
+            stop_.store(true, std::memory_order_relaxed);
+            wake_epoch_.fetch_add(1, std::memory_order_release);
+            wake_epoch_.notify_all();
+            for (auto& thread : threads_)
+                thread.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        /// pool shared by the parallel algorithms of nbkit when none is given
+        static ThreadPool& GetDefault()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        static size_t GetDefaultThreadCount() { return std::max(1u, std::thread::hardware_concurrency()) - 1; }
+
+        size_t GetThreadCount() const { return threads_.size(); }
+
+        /// calls body(i) for every i in [0, count) and returns once they are all done, body must not throw
+        template <typename Body>
+        void ParallelFor(size_t count, const Body& body)
+        {
+            if (count == 0)
+                return;
+            if (count == 1 || threads_.empty())
+            {
+                for (size_t i = 0; i < count; ++i)
+                    body(i);
+                return;
+            }
+
+            Job job;
+            job.run = [](const void* erased, size_t index) { (*static_cast<const Body*>(erased))(index); };
+            job.body = &body;
+            job.remaining.store(count, std::memory_order_relaxed);
+
+            const size_t queue = GetOwnQueue();
+            Execute(Task { &job, 0, count }, queue);
+
+            // help with any task until the last iteration of this job is done, some may still run elsewhere
+            while (job.remaining.load(std::memory_order_acquire) > 0)
+            {
+                Task task;
+                if (TryPop(queue, task) || TrySteal(queue, task))
+                    Execute(task, queue);
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+        size_t GetOwnQueue() const { return current_pool_ == this ? current_queue_ : queue_count_ - 1; }
+
+        void Push(size_t queue, const Task& task)
+        {
+            {
+                std::lock_guard lock(queues_[queue].mutex);
+                queues_[queue].tasks.push_back(task);
+            }
+
+            wake_epoch_.fetch_add(1, std::memory_order_release);
+            wake_epoch_.notify_one();
+        }
+
+        bool TryPop(size_t queue, Task& task)
+        {
+            std::lock_guard lock(queues_[queue].mutex);
+            if (queues_[queue].tasks.empty())
+                return false;
+            task = queues_[queue].tasks.back();
+            queues_[queue].tasks.pop_back();
+            return true;
+        }
+
+        bool TrySteal(size_t thief, Task& task)
+        {
+            for (size_t i = 1; i < queue_count_; ++i)
+            {
+                Queue& victim = queues_[(thief + i) % queue_count_];
+                std::lock_guard lock(victim.mutex);
+                if (victim.tasks.empty())
+                    continue;
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+            return false;
+        }
+
+        // splits off the upper halves for the thieves, then runs the first iteration
+        void Execute(Task task, size_t queue)
+        {
+            while (task.end - task.begin > 1)
+            {
+                const size_t middle = task.begin + (task.end - task.begin) / 2;
+                Push(queue, Task { task.job, middle, task.end });
+                task.end = middle;
+            }
+
+            Job* job = task.job;
+            job->run(job->body, task.begin);
+            job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        void Run(size_t queue)
+        {
+            current_pool_ = this;
+            current_queue_ = queue;
+
+            for (;;)
+            {
+                // read before looking for tasks, so a push happening after the search changes it and ends the wait
+                const uint32_t epoch = wake_epoch_.load(std::memory_order_acquire);
+
+                Task task;
+                if (TryPop(queue, task) || TrySteal(queue, task))
+                {
+                    Execute(task, queue);
+                    continue;
+                }
+
+                if (stop_.load(std::memory_order_relaxed))
+                    return;
+                wake_epoch_.wait(epoch, std::memory_order_acquire);
+            }
+        }
+    };
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "nbkit/matrix.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace nbkit
+{
+    /// <summary>
+    /// Matrix that records which TileSize x TileSize tiles were written since the last ClearDirty, so consumers
+    /// (uploads, serialization, redraws) only process what changed. Writes through the non-const Get, Set, Row,
+    /// SubMatrix, AsView and iterators set the bit of the tiles they may touch; each write costs one OR into a bit set.
+    /// Writes through GetMatrix() or pointers kept from earlier views are not seen, call MarkDirty for those.
+    /// </summary>
+    template <typename T, size_t TileSize = 64, typename Layout = RowMajorLayout, typename Allocator = std::allocator<T>>
+    class TrackedMatrix
+    {
+        static_assert(std::has_single_bit(TileSize), "TileSize must be a power of two");
+
+        // -------------------------------------------------------------------- fields
+    private:
+        static constexpr size_t kTileShift = std::countr_zero(TileSize);
+
+        Matrix<T, Layout, Allocator> matrix_;
+        size_t tiles_x_ = 0;
+        std::vector<uint64_t> dirty_;
+
+        // -------------------------------------------------------------------- methods
+    public:
+        TrackedMatrix() = default;
+
+        /// every tile starts dirty, nothing of the matrix has been consumed yet
+        TrackedMatrix(size_t width, size_t height, const Allocator& allocator = Allocator()) : matrix_(allocator)
+        {
+            Resize(width, height);
+        }
+
+        explicit TrackedMatrix(Matrix<T, Layout, Allocator> matrix) : matrix_(std::move(matrix))
+        {
+            ResetTiles();
+        }
+
+        size_t GetSizeX() const { return matrix_.GetSizeX(); }
+        size_t GetSizeY() const { return matrix_.GetSizeY(); }
+
+        /// elements keep their position, every tile becomes dirty
+        void Resize(size_t width, size_t height)
+        {
+            matrix_.Resize(width, height);
+            ResetTiles();
+        }
+
+        /// read-only access to the tracked matrix, e.g. for matrix_ops
+        const Matrix<T, Layout, Allocator>& GetMatrix() const { return matrix_; }
+
+        const T& Get(size_t x, size_t y) const { return matrix_.Get(x, y); }
+
+        T& Get(size_t x, size_t y)
+        {
+            // the matrix checks the bounds first, so a bad coordinate never reaches the bit set
+            T& element = matrix_.Get(x, y);
+            MarkTile(x >> kTileShift, y >> kTileShift);
+            return element;
+        }
+
+        void Set(size_t x, size_t y, const T& value) { Get(x, y) = value; }
+
+        // -------------------------------------------------------------------- views (layouts with contiguous rows only)
+        // mutable views mark their whole region dirty when they are created
+    public:
+        std::span<T> Row(size_t y) requires Layout::kHasContiguousRows
+        {
+            MarkDirty(0, y, GetSizeX(), 1);
+            return matrix_.Row(y);
+        }
+
+        std::span<const T> Row(size_t y) const requires Layout::kHasContiguousRows { return matrix_.Row(y); }
+
+        MatrixView<T> SubMatrix(size_t x, size_t y, size_t width, size_t height) requires Layout::kHasContiguousRows
+        {
+            MarkDirty(x, y, width, height);
+            return matrix_.SubMatrix(x, y, width, height);
+        }
+
+        MatrixView<const T> SubMatrix(size_t x, size_t y, size_t width, size_t height) const requires Layout::kHasContiguousRows
+        {
+            return matrix_.SubMatrix(x, y, width, height);
+        }
+
+        MatrixView<T> AsView() requires Layout::kHasContiguousRows
+        {
+            MarkDirty(0, 0, GetSizeX(), GetSizeY());
+            return matrix_.AsView();
+        }
+
+        MatrixView<const T> AsView() const requires Layout::kHasContiguousRows { return matrix_.AsView(); }
+
+        // -------------------------------------------------------------------- dirty tiles
+    public:
+        static constexpr size_t GetTileSize() { return TileSize; }
+
+        /// marks the tiles overlapping the region, for writes the matrix can't see; the region is clipped to the matrix
+        void MarkDirty(size_t x, size_t y, size_t width, size_t height)
+        {
+            if (x >= GetSizeX() || y >= GetSizeY())
+                return;
+            width = std::min(width, GetSizeX() - x);
+            height = std::min(height, GetSizeY() - y);
+            if (width == 0 || height == 0)
+                return;
+            for (size_t ty = y >> kTileShift; ty <= (y + height - 1) >> kTileShift; ++ty)
+                for (size_t tx = x >> kTileShift; tx <= (x + width - 1) >> kTileShift; ++tx)
+                    MarkTile(tx, ty);
+        }
+
+        bool IsTileDirty(size_t tile_x, size_t tile_y) const
+        {
+            const size_t tile = tiles_x_ * tile_y + tile_x;
+            return (dirty_[tile / 64] >> (tile % 64) & 1) != 0;
+        }
+
+        size_t GetDirtyTileCount() const
+        {
+            size_t count = 0;
+            for (uint64_t word : dirty_)
+                count += static_cast<size_t>(std::popcount(word));
+            return count;
+        }
+
+        /// calls function(x, y, width, height) with the cell region of each dirty tile, row of tiles by row of tiles;
+        /// edge tiles are clipped to the matrix
+        template <typename Function>
+        void ForEachDirtyTile(const Function& function) const
+        {
+            for (size_t word = 0; word < dirty_.size(); ++word)
+                for (uint64_t bits = dirty_[word]; bits != 0; bits &= bits - 1)
+                {
+                    const size_t tile = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+                    const size_t x = (tile % tiles_x_) << kTileShift;
+                    const size_t y = (tile / tiles_x_) << kTileShift;
+                    function(x, y, std::min(TileSize, GetSizeX() - x), std::min(TileSize, GetSizeY() - y));
+                }
+        }
+
+        void ClearDirty() { std::fill(dirty_.begin(), dirty_.end(), uint64_t { 0 }); }
+
+    private:
+        void MarkTile(size_t tile_x, size_t tile_y)
+        {
+            const size_t tile = tiles_x_ * tile_y + tile_x;
+            dirty_[tile / 64] |= uint64_t { 1 } << (tile % 64);
+        }
+
+        void ResetTiles()
+        {
+            tiles_x_ = (GetSizeX() + TileSize - 1) >> kTileShift;
+            const size_t tiles = tiles_x_ * ((GetSizeY() + TileSize - 1) >> kTileShift);
+            dirty_.assign((tiles + 63) / 64, ~uint64_t { 0 });
+            if (tiles % 64 != 0)
+                dirty_.back() = (uint64_t { 1 } << (tiles % 64)) - 1;
+        }
+
+        // -------------------------------------------------------------------- iterator
+        // walks rows top to bottom like Matrix iterators, dereferencing marks the tile of the element
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+        private:
+            TrackedMatrix* matrix_ = nullptr;
+            size_t x_ = 0;
+            size_t y_ = 0;
+
+        public:
+            Iterator() = default;
+            Iterator(TrackedMatrix* matrix, size_t index) : matrix_(matrix) { SetIndex(index); }
+
+            reference operator*() const { return matrix_->Get(x_, y_); }
+            pointer operator->() const { return &matrix_->Get(x_, y_); }
+            Iterator& operator++() { if (++x_ == matrix_->GetSizeX()) { x_ = 0; ++y_; } return *this; }
+            Iterator operator++(int) { Iterator temp = *this; ++*this; return temp; }
+            Iterator& operator--() { if (x_-- == 0) { x_ = matrix_->GetSizeX() - 1; --y_; } return *this; }
+            Iterator operator--(int) { Iterator temp = *this; --*this; return temp; }
+            Iterator operator+(difference_type n) const { return Iterator(matrix_, GetIndex() + n); }
+            Iterator operator-(difference_type n) const { return Iterator(matrix_, GetIndex() - n); }
+            Iterator& operator+=(difference_type n) { SetIndex(GetIndex() + n); return *this; }
+            Iterator& operator-=(difference_type n) { SetIndex(GetIndex() - n); return *this; }
+            difference_type operator-(const Iterator& other) const { return static_cast<difference_type>(GetIndex() - other.GetIndex()); }
+            bool operator==(const Iterator& other) const { return x_ == other.x_ && y_ == other.y_; }
+            bool operator!=(const Iterator& other) const { return !(*this == other); }
+            bool operator<(const Iterator& other) const { return GetIndex() < other.GetIndex(); }
+            bool operator<=(const Iterator& other) const { return GetIndex() <= other.GetIndex(); }
+            bool operator>(const Iterator& other) const { return GetIndex() > other.GetIndex(); }
+            bool operator>=(const Iterator& other) const { return GetIndex() >= other.GetIndex(); }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+        private:
+            size_t GetIndex() const { return y_ * matrix_->GetSizeX() + x_; }
+
+            void SetIndex(size_t index)
+            {
+                const size_t width = matrix_->GetSizeX();
+                x_ = width == 0 ? 0 : index % width;
+                y_ = width == 0 ? 0 : index / width;
+            }
+        };
+
+        using iterator = Iterator;
+        using const_iterator = typename Matrix<T, Layout, Allocator>::const_iterator;
+
+        iterator begin() { return Iterator(this, 0); }
+        iterator end() { return Iterator(this, GetSizeX() * GetSizeY()); }
+        const_iterator begin() const { return matrix_.begin(); }
+        const_iterator end() const { return matrix_.end(); }
+    };
+}
@@ -0,0 +1,65 @@
+// built as its own test program with NBKIT_MATRIX_BOUNDS_CHECK defined, every translation unit of a program must
+// agree on it
+#include "nbkit/matrix.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::Matrix;
+
+#ifndef NBKIT_MATRIX_BOUNDS_CHECK
+    #error "NBKIT_MATRIX_BOUNDS_CHECK must be defined for this test program"
+#endif
+
+class MatrixBoundsCheckTest : public ::testing::Test
+{
+protected:
+    Matrix<int> matrix_ { 3, std::vector<int>{ 0, 1, 2, 3, 4, 5 } };
+};
+
+TEST_F(MatrixBoundsCheckTest, InRangeAccessPasses)
+{
+    EXPECT_EQ(matrix_.Get(2, 1), 5);
+    EXPECT_EQ(matrix_.RowPtr(1)[0], 3);
+}
+
+TEST_F(MatrixBoundsCheckTest, ColumnPastWidthAborts)
+{
+    // without the check, (3, 0) would read (0, 1)
+    EXPECT_DEATH(matrix_.Get(3, 0), R"(nbkit::Matrix::Get\(3, 0\) out of bounds of a 3 x 2 matrix)");
+}
+
+TEST_F(MatrixBoundsCheckTest, RowPastHeightAborts)
+{
+    EXPECT_DEATH(matrix_.Get(0, 2), R"(Get\(0, 2\) out of bounds)");
+    EXPECT_DEATH(matrix_.RowPtr(2), R"(RowPtr\(0, 2\) out of bounds)");
+}
+
+TEST_F(MatrixBoundsCheckTest, TiledLayoutIsChecked)
+{
+    nbkit::Matrix<int, nbkit::TiledLayout<4, 4>> tiled(3, std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+
+    // lands in the tile padding without the check
+    EXPECT_DEATH(tiled.Get(3, 1), R"(Get\(3, 1\) out of bounds of a 3 x 2 matrix)");
+}
+
+TEST_F(MatrixBoundsCheckTest, EmptyMatrixAborts)
+{
+    Matrix<int> empty;
+    empty.Resize(0, 5);
+
+    EXPECT_DEATH(empty.Get(0, 0), R"(Get\(0, 0\) out of bounds of a 0 x 0 matrix)");
+}
+
+TEST_F(MatrixBoundsCheckTest, ViewsAreChecked)
+{
+    EXPECT_EQ(matrix_.Row(1)[2], 5);
+    EXPECT_EQ(matrix_.Col(2)[1], 5);
+    EXPECT_EQ(matrix_.SubMatrix(1, 1, 2, 1).Get(1, 0), 5);
+    EXPECT_EQ(matrix_.SubMatrix(3, 2, 0, 0).GetSizeX(), 0);
+
+    EXPECT_DEATH(matrix_.Row(2), R"(Row\(0, 2\) out of bounds of a 3 x 2 matrix)");
+    EXPECT_DEATH(matrix_.Col(3), R"(Col\(3, 0, 1, 2\) out of bounds of a 3 x 2 matrix)");
+    EXPECT_DEATH(matrix_.SubMatrix(2, 0, 2, 1), R"(SubMatrix\(2, 0, 2, 1\) out of bounds of a 3 x 2 matrix)");
+    EXPECT_DEATH(matrix_.SubMatrix(0, 1, 1, 2), R"(SubMatrix\(0, 1, 1, 2\) out of bounds)");
+}
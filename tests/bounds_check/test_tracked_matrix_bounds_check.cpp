@@ -0,0 +1,16 @@
+// built into the bounds check test program, see test_matrix_bounds_check.cpp
+#include "nbkit/tracked_matrix.h"
+
+#include <gtest/gtest.h>
+
+using nbkit::TrackedMatrix;
+
+TEST(TrackedMatrixBoundsCheckTest, OutOfRangeWritesAbortBeforeMarking)
+{
+    TrackedMatrix<int, 4> matrix(6, 6);
+
+    // tile (2, 3) doesn't exist, marking it first would write past the bit set
+    EXPECT_DEATH(matrix.Get(9, 13), R"(Get\(9, 13\) out of bounds of a 6 x 6 matrix)");
+    EXPECT_DEATH(matrix.Set(6, 0, 1), R"(Get\(6, 0\) out of bounds)");
+    EXPECT_DEATH(*(matrix.begin() + 36), R"(Get\(0, 6\) out of bounds)");
+}
@@ -0,0 +1,40 @@
+# Usage: cmake -DASM_FILE=<file.s> -DFUNCTIONS=<f1;f2;...> -P check_empty_functions.cmake
+# Fails if any of the functions contains an instruction other than a return.
+
+# ';' and brackets (e.g. in string constants) would break CMake list handling
+file(READ "${ASM_FILE}" asm)
+string(REGEX REPLACE "[][;]" " " asm "${asm}")
+string(REPLACE "\n" ";" asm_lines "${asm}")
+
+foreach(function IN LISTS FUNCTIONS)
+    set(inside FALSE)
+    set(found FALSE)
+    set(instructions "")
+
+    foreach(line IN LISTS asm_lines)
+        if(line MATCHES "^_?${function}:")
+            set(inside TRUE)
+            set(found TRUE)
+        elseif(inside)
+            string(STRIP "${line}" line)
+            if(line MATCHES "^\\.cfi_endproc" OR line MATCHES "^\\.size")
+                break()
+            endif()
+            # skip directives, labels and comments
+            if(line STREQUAL "" OR line MATCHES "^[.#;]" OR line MATCHES "^[A-Za-z0-9_.$]+:")
+                continue()
+            endif()
+            if(NOT line MATCHES "^(rep )?ret" AND NOT line MATCHES "^endbr64")
+                list(APPEND instructions "${line}")
+            endif()
+        endif()
+    endforeach()
+
+    if(NOT found)
+        message(FATAL_ERROR "${function} not found in ${ASM_FILE}")
+    endif()
+    if(instructions)
+        message(FATAL_ERROR "${function} is not empty: ${instructions}")
+    endif()
+    message(STATUS "${function}: empty")
+endforeach()
@@ -0,0 +1,29 @@
+// Compiled to assembly by the codegen test: every function below must compile to a bare return,
+// because Verbose is under NBKIT_LOG_MIN_LEVEL.
+
+#define NBKIT_LOG_MIN_LEVEL NBKIT_LOG_LEVEL_INFO
+#include "nbkit/log.h"
+
+using namespace nbkit::log;
+
+int Expensive();
+
+extern "C" void NbkitCodegenVerboseLiteral()
+{
+    Verbose("filtered");
+}
+
+extern "C" void NbkitCodegenVerboseLazy()
+{
+    Verbose("filtered ", []() { return Expensive(); });
+}
+
+extern "C" void NbkitCodegenVerboseRuntime()
+{
+    VerboseRuntime(Channel::kDefault, "filtered");
+}
+
+extern "C" void NbkitCodegenVerboseMacro()
+{
+    NBKIT_LOG_VERBOSE(Channel::kDefault, "filtered ", Expensive());
+}
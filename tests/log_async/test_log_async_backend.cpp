@@ -0,0 +1,74 @@
+// built as its own test program with NBKIT_LOG_ASYNC defined, every translation unit of a program must agree on it
+#include "nbkit/log.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef NBKIT_LOG_ASYNC
+    #error "NBKIT_LOG_ASYNC must be defined for this test program"
+#endif
+
+using namespace nbkit::log;
+
+class LogAsyncBackendTest : public ::testing::Test
+{
+protected:
+    std::ostringstream out_;
+    OStreamSink sink_ { out_, false };
+
+    void SetUp() override { SetSink(sink_); }
+
+    void TearDown() override
+    {
+        Flush();
+        SetSink(GetDefaultSink());
+    }
+};
+
+TEST_F(LogAsyncBackendTest, RecordsReachTheSinkOnFlush)
+{
+    Info("value=", 42);
+    NBKIT_LOG_WARNING(Channel::kDefault, "from the macro ", 1.5);
+    ErrorRuntime(Channel::kDefault, "runtime channel");
+    Flush();
+
+    EXPECT_EQ(out_.str(), "[kDefault] value=42\n[kDefault] from the macro 1.5\n[kDefault] runtime channel\n");
+    EXPECT_EQ(GetDroppedCount(), 0);
+}
+
+TEST_F(LogAsyncBackendTest, ArgumentsAreCapturedAtTheCall)
+{
+    std::string text = "before";
+    Info(text);
+    text = "after";
+    Flush();
+
+    EXPECT_EQ(out_.str(), "[kDefault] before\n");
+}
+
+TEST_F(LogAsyncBackendTest, EachThreadKeepsItsOrder)
+{
+    constexpr int kThreads = 4;
+    constexpr int kRecords = 200;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([t] { for (int i = 0; i < kRecords; ++i) Info(t, ":", i); });
+    for (std::thread& thread : threads)
+        thread.join();
+    Flush();
+
+    std::vector<int> next(kThreads, 0);
+    std::istringstream lines(out_.str());
+    int count = 0;
+    for (std::string line; std::getline(lines, line); ++count)
+    {
+        const size_t colon = line.find(':');
+        const int t = std::stoi(line.substr(11, colon - 11));
+        EXPECT_EQ(std::stoi(line.substr(colon + 1)), next[t]++);
+    }
+    EXPECT_EQ(count, kThreads * kRecords);
+}
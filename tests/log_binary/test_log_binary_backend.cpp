@@ -0,0 +1,77 @@
+// built as its own test program with NBKIT_LOG_BINARY defined, every translation unit of a program must agree on it
+#include "nbkit/log.h"
+
+#include <gtest/gtest.h>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#ifndef NBKIT_LOG_BINARY
+    #error "NBKIT_LOG_BINARY must be defined for this test program"
+#endif
+
+using namespace nbkit::log;
+
+namespace
+{
+    // not binary encodable, formatted on the calling thread
+    struct Point
+    {
+        int x = 0;
+        int y = 0;
+    };
+
+    std::ostream& operator<<(std::ostream& out, const Point& point) { return out << "(" << point.x << ", " << point.y << ")"; }
+}
+
+class LogBinaryBackendTest : public ::testing::Test
+{
+protected:
+    std::ostringstream out_;
+    OStreamSink sink_ { out_, false };
+
+    void SetUp() override
+    {
+        Flush();
+        SetSink(sink_);
+    }
+
+    void TearDown() override
+    {
+        Flush();
+        SetSink(GetDefaultSink());
+    }
+};
+
+TEST_F(LogBinaryBackendTest, MacrosAndFunctionsDecodeToText)
+{
+    NBKIT_LOG_INFO(Channel::kDefault, "value=", 42, " ratio=", 0.5);
+    Warning("flag=", true, " char=", 'c');
+    ErrorRuntime(Channel::kDefault, "runtime ", uint64_t { 7 });
+    Flush();
+
+    EXPECT_EQ(out_.str(), "[kDefault] value=42 ratio=0.5\n[kDefault] flag=1 char=c\n[kDefault] runtime 7\n");
+    EXPECT_EQ(GetDroppedCount(), 0);
+}
+
+TEST_F(LogBinaryBackendTest, OtherArgumentsAreFormattedAtTheCall)
+{
+    Point point { 1, 2 };
+    std::string text = "before";
+    NBKIT_LOG_INFO(Channel::kDefault, "point ", point, " ", text);
+    InfoRuntime(Channel::kDefault, point);
+    point.x = 9;
+    text = "after";
+    Flush();
+
+    EXPECT_EQ(out_.str(), "[kDefault] point (1, 2) before\n[kDefault] (1, 2)\n");
+}
+
+TEST_F(LogBinaryBackendTest, SitesAreRegisteredOncePerCall)
+{
+    for (int i = 0; i < 3; ++i)
+        NBKIT_LOG_INFO(Channel::kDefault, "i=", i);
+    Flush();
+
+    EXPECT_EQ(out_.str(), "[kDefault] i=0\n[kDefault] i=1\n[kDefault] i=2\n");
+}
@@ -0,0 +1,45 @@
+// built as its own test program with NBKIT_LOG_FORMAT_JSON defined, every translation unit of a program must agree on it
+#include "nbkit/log.h"
+
+#include <gtest/gtest.h>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#ifndef NBKIT_LOG_FORMAT_JSON
+    #error "NBKIT_LOG_FORMAT_JSON must be defined for this test program"
+#endif
+
+using namespace nbkit::log;
+
+class LogJsonTest : public ::testing::Test
+{
+protected:
+    std::ostringstream out_;
+    OStreamSink sink_ { out_, true };
+
+    void SetUp() override { SetSink(sink_); }
+    void TearDown() override { SetSink(GetDefaultSink()); }
+};
+
+TEST_F(LogJsonTest, MacrosWriteCallSiteFields)
+{
+    const uint32_t line = __LINE__ + 1;
+    NBKIT_LOG_WARNING(Channel::kDefault, "disk at ", 93, "% \"full\"");
+
+    // colors are never written into structured records
+    const std::regex expected(R"(\{"ts":[1-9][0-9]*,"level":"warning","channel":"kDefault","thread":[1-9][0-9]*,)"
+                              R"("file":"[^"]*test_log_json\.cpp","line":)" + std::to_string(line) +
+                              R"(,"msg":"disk at 93% \\"full\\""\}\n)");
+    EXPECT_TRUE(std::regex_match(out_.str(), expected)) << out_.str();
+}
+
+TEST_F(LogJsonTest, FunctionsLeaveTheCallSiteOut)
+{
+    Info("a\tb");
+    ErrorRuntime(Channel::kDefault, "runtime");
+
+    const std::regex expected(R"(\{"ts":[0-9]+,"level":"info","channel":"kDefault","thread":[0-9]+,"msg":"a\\tb"\}\n)"
+                              R"(\{"ts":[0-9]+,"level":"error","channel":"kDefault","thread":[0-9]+,"msg":"runtime"\}\n)");
+    EXPECT_TRUE(std::regex_match(out_.str(), expected)) << out_.str();
+}
@@ -0,0 +1,45 @@
+// built as its own test program with NBKIT_LOG_FORMAT_LOGFMT defined, every translation unit of a program must agree on it
+#include "nbkit/log.h"
+
+#include <gtest/gtest.h>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#ifndef NBKIT_LOG_FORMAT_LOGFMT
+    #error "NBKIT_LOG_FORMAT_LOGFMT must be defined for this test program"
+#endif
+
+using namespace nbkit::log;
+
+class LogLogfmtTest : public ::testing::Test
+{
+protected:
+    std::ostringstream out_;
+    OStreamSink sink_ { out_, true };
+
+    void SetUp() override { SetSink(sink_); }
+    void TearDown() override { SetSink(GetDefaultSink()); }
+};
+
+TEST_F(LogLogfmtTest, MacrosWriteCallSiteFields)
+{
+    const uint32_t line = __LINE__ + 1;
+    NBKIT_LOG_ERROR(Channel::kDefault, "retry ", 3, " of \"job\"");
+
+    // colors are never written into structured records
+    const std::regex expected(R"(ts=[1-9][0-9]* level=error channel=kDefault thread=[1-9][0-9]* )"
+                              R"(file=[^ ]*test_log_logfmt\.cpp line=)" + std::to_string(line) +
+                              R"( msg="retry 3 of \\"job\\""\n)");
+    EXPECT_TRUE(std::regex_match(out_.str(), expected)) << out_.str();
+}
+
+TEST_F(LogLogfmtTest, FunctionsLeaveTheCallSiteOut)
+{
+    Sparkle("done");
+    InfoRuntime(Channel::kDefault, "x=1");
+
+    const std::regex expected(R"(ts=[0-9]+ level=sparkle channel=kDefault thread=[0-9]+ msg="done"\n)"
+                              R"(ts=[0-9]+ level=info channel=kDefault thread=[0-9]+ msg="x=1"\n)");
+    EXPECT_TRUE(std::regex_match(out_.str(), expected)) << out_.str();
+}
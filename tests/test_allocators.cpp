@@ -0,0 +1,91 @@
+#include "nbkit/allocators.h"
+#include "nbkit/matrix.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::AlignedAllocator;
+using nbkit::Arena;
+using nbkit::ArenaAllocator;
+using nbkit::HugePageAllocator;
+using nbkit::Matrix;
+
+namespace
+{
+    bool IsAligned(const void* p, size_t alignment) { return reinterpret_cast<uintptr_t>(p) % alignment == 0; }
+}
+
+TEST(AllocatorsTest, AlignedAllocatorAlignsStorage)
+{
+    for (size_t size : { 1, 3, 100, 4097 })
+    {
+        std::vector<float, AlignedAllocator<float>> values(size);
+        EXPECT_TRUE(IsAligned(values.data(), 64));
+
+        std::vector<char, AlignedAllocator<char, 4096>> page(size);
+        EXPECT_TRUE(IsAligned(page.data(), 4096));
+    }
+}
+
+TEST(AllocatorsTest, HugePageAllocatorSmallAndLargeBlocks)
+{
+    std::vector<int, HugePageAllocator<int>> small(10, 7);
+    EXPECT_TRUE(IsAligned(small.data(), 64));
+    EXPECT_EQ(small[9], 7);
+
+    // above the huge page size, mapped memory starts zeroed and is page aligned
+    std::vector<int, HugePageAllocator<int>> large(HugePageAllocator<int>::kHugePageSize, 3);
+    EXPECT_TRUE(IsAligned(large.data(), 4096));
+    EXPECT_EQ(large.front(), 3);
+    EXPECT_EQ(large.back(), 3);
+}
+
+TEST(AllocatorsTest, ArenaBumpsAndResets)
+{
+    Arena arena(1024);
+
+    void* first = arena.Allocate(10, 8);
+    void* second = arena.Allocate(10, 64);
+    EXPECT_TRUE(IsAligned(second, 64));
+    EXPECT_GT(static_cast<char*>(second), static_cast<char*>(first));
+    EXPECT_EQ(arena.GetReservedSize(), 1024 + 64);
+
+    // larger than a block, gets its own
+    arena.Allocate(5000, 8);
+    EXPECT_EQ(arena.GetReservedSize(), 1024 + 64 + 5000 + 64);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetReservedSize(), 0);
+}
+
+TEST(AllocatorsTest, MatrixFromArena)
+{
+    Arena arena;
+    {
+        using ArenaMatrix = Matrix<float, nbkit::RowMajorLayout, ArenaAllocator<float>>;
+
+        ArenaMatrix matrix(3, std::vector<float>{ 1, 2, 3, 4, 5, 6 }, arena);
+        ArenaMatrix copy = matrix;
+        copy.Get(0, 0) = 10;
+
+        EXPECT_TRUE(IsAligned(matrix.GetData(), 64));
+        EXPECT_EQ(matrix.Get(0, 0), 1);
+        EXPECT_EQ(copy.Get(0, 0), 10);
+        EXPECT_EQ(&copy.GetAllocator().GetArena(), &arena);
+    }
+    arena.Reset();
+}
+
+TEST(AllocatorsTest, PaddedRowsStartOnCacheLines)
+{
+    Matrix<float, nbkit::CacheLinePaddedLayout<float>, AlignedAllocator<float>> matrix;
+    matrix.Resize(21, 5);
+
+    for (size_t y = 0; y < 5; ++y)
+    {
+        EXPECT_TRUE(IsAligned(matrix.Row(y).data(), 64)) << "row " << y;
+        EXPECT_EQ(matrix.Row(y).size(), 21);
+    }
+    EXPECT_EQ(matrix.AsView().GetRowStride(), 32);
+}
@@ -0,0 +1,159 @@
+#include "nbkit/delegate.h"
+
+#include <gtest/gtest.h>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using nbkit::Delegate;
+
+namespace
+{
+    struct Counter
+    {
+        int total = 0;
+
+        void Add(int value) { total += value; }
+        int Get() const { return total; }
+    };
+
+    int Twice(int value) { return value * 2; }
+
+    // callable whose copies throw once armed, like a wrapped std::function running out of memory
+    struct ThrowingCopy
+    {
+        std::shared_ptr<bool> armed = std::make_shared<bool>(false);
+        int value = 0;
+
+        ThrowingCopy(int v) : value(v) {}
+        ThrowingCopy(const ThrowingCopy& other) : armed(other.armed), value(other.value)
+        {
+            if (*armed)
+                throw std::bad_alloc();
+        }
+        ThrowingCopy(ThrowingCopy&&) noexcept = default;
+
+        int operator()() const { return value; }
+    };
+}
+
+TEST(DelegateTest, EmptyByDefault)
+{
+    Delegate<void()> delegate;
+    EXPECT_FALSE(delegate);
+
+    Delegate<void()> null_delegate = nullptr;
+    EXPECT_FALSE(null_delegate);
+}
+
+TEST(DelegateTest, CallsLambdaWithCaptures)
+{
+    int a = 1;
+    int b = 2;
+    int c = 3;
+    Delegate<int(int)> delegate = [&a, &b, &c](int x) { return a + b + c + x; };
+
+    ASSERT_TRUE(delegate);
+    EXPECT_EQ(delegate(4), 10);
+}
+
+TEST(DelegateTest, ForwardsArgumentsAndReturnValue)
+{
+    Delegate<std::string(const std::string&, std::string)> concat = [](const std::string& a, std::string b) { return a + b; };
+    EXPECT_EQ(concat("ab", "cd"), "abcd");
+
+    Delegate<int(std::unique_ptr<int>)> take = [](std::unique_ptr<int> value) { return *value; };
+    EXPECT_EQ(take(std::make_unique<int>(7)), 7);
+}
+
+TEST(DelegateTest, BindsMemberFunctions)
+{
+    Counter counter;
+    auto add = Delegate<void(int)>::Bind<&Counter::Add>(&counter);
+    auto get = Delegate<int()>::Bind<&Counter::Get>(static_cast<const Counter*>(&counter));
+
+    add(5);
+    add(6);
+    EXPECT_EQ(counter.total, 11);
+    EXPECT_EQ(get(), 11);
+}
+
+TEST(DelegateTest, CopiesAndMovesNonTrivialCallables)
+{
+    auto shared = std::make_shared<int>(0);
+    Delegate<void()> original = [shared] { ++*shared; };
+    EXPECT_EQ(shared.use_count(), 2);
+
+    Delegate<void()> copy = original;
+    EXPECT_EQ(shared.use_count(), 3);
+
+    Delegate<void()> moved = std::move(copy);
+    EXPECT_EQ(shared.use_count(), 3);
+
+    original();
+    moved();
+    EXPECT_EQ(*shared, 2);
+
+    original = nullptr;
+    moved.Reset();
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(DelegateTest, RelocatesInsideVector)
+{
+    std::vector<Delegate<int(), 48>> delegates;
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i % 2 == 0)
+            delegates.emplace_back([i] { return i; });
+        else
+            delegates.emplace_back([text = std::string(40, 'x'), i] { return static_cast<int>(text.size()) * 0 + i; });
+    }
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(delegates[i](), i);
+}
+
+TEST(DelegateTest, CapacityIsConfigurable)
+{
+    char payload[48] = { 1 };
+    Delegate<int(), 64> delegate = [payload] { return static_cast<int>(payload[0]); };
+
+    EXPECT_EQ(delegate.kCapacity, 64u);
+    EXPECT_EQ(delegate(), 1);
+}
+
+TEST(DelegateTest, CallsFreeFunctionsByName)
+{
+    Delegate<int(int)> delegate = Twice;
+    EXPECT_EQ(delegate(21), 42);
+
+    delegate = &Twice;
+    EXPECT_EQ(delegate(4), 8);
+}
+
+TEST(DelegateTest, DefaultCapacityHoldsStdFunction)
+{
+    static_assert(Delegate<void(int)>::kCapacity >= sizeof(std::function<void(int)>));
+
+    char payload[200] = { 5 };
+    std::function<int()> wrapped = [payload] { return static_cast<int>(payload[0]); };
+    Delegate<int()> delegate = wrapped;
+
+    EXPECT_EQ(delegate(), 5);
+}
+
+TEST(DelegateTest, ThrowingCopyAssignmentKeepsTarget)
+{
+    ThrowingCopy source_callable(1);
+    const Delegate<int()> source = source_callable;
+    Delegate<int()> target = ThrowingCopy(2);
+
+    *source_callable.armed = true;
+    EXPECT_THROW(target = source, std::bad_alloc);
+
+    EXPECT_TRUE(target);
+    EXPECT_EQ(target(), 2);
+}
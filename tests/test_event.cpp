@@ -1,5 +1,7 @@
 #include "nbkit/event.h"
 
+#include <array>
+#include <functional>
 #include <gtest/gtest.h>
 #include <string>
 
@@ -106,4 +108,85 @@ TEST_F(EventTest, NotifyWithZeroSubscribers)
     EXPECT_NO_THROW(event_void.Notify());
     EXPECT_NO_THROW(event_int.Notify(42));
     EXPECT_NO_THROW(event_string.Notify("Test"));
-}
\ No newline at end of file
+}
+namespace
+{
+    int free_function_total = 0;
+
+    void AddToTotal(int value) { free_function_total += value; }
+
+    struct Listener
+    {
+        int received = 0;
+
+        void OnValue(int value) { received += value; }
+    };
+}
+
+TEST_F(EventTest, MemberFunctionSubscription)
+{
+    Event<int> event;
+    Listener first;
+    Listener second;
+
+    event.Subscribe<&Listener::OnValue>(&first);
+    event.Subscribe<&Listener::OnValue>(&second);
+    event.Notify(3);
+
+    EXPECT_EQ(first.received, 3);
+    EXPECT_EQ(second.received, 3);
+}
+
+TEST_F(EventTest, NotifiesInSubscriptionOrder)
+{
+    Event<> event;
+    std::string order;
+
+    for (char name : std::string("abcdefghij"))
+        event.Subscribe([&order, name]() { order += name; });
+
+    event.Notify();
+    EXPECT_EQ(order, "abcdefghij");
+}
+
+TEST_F(EventTest, FreeFunctionSubscription)
+{
+    Event<int> event;
+    free_function_total = 0;
+
+    event.Subscribe(AddToTotal);
+    event.Subscribe(&AddToTotal);
+    event.Notify(1);
+
+    EXPECT_EQ(free_function_total, 2);
+}
+
+TEST_F(EventTest, StdFunctionAndLargeCapturesSubscribe)
+{
+    Event<int> event;
+    int sum = 0;
+    std::function<void(int)> callback = [&sum](int value) { sum += value; };
+    std::array<int, 32> weights {};
+    weights.fill(3);
+
+    event.Subscribe(callback);
+    // too big for a Delegate, wrapped in a std::function
+    event.Subscribe(std::function<void(int)>([&sum, weights](int value) { sum += value * weights[31]; }));
+    event.Notify(2);
+
+    EXPECT_EQ(sum, 8);
+}
+
+TEST_F(EventTest, CapacityCanBeRaised)
+{
+    nbkit::EventWithCapacity<128, int> event;
+    std::array<int, 24> weights {};
+    weights.fill(2);
+    int sum = 0;
+
+    static_assert(sizeof(weights) > Event<int>::Callback::kCapacity);
+    event.Subscribe([&sum, weights](int value) { sum += value * weights[23]; });
+    event.Notify(5);
+
+    EXPECT_EQ(sum, 10);
+}
@@ -0,0 +1,104 @@
+#include "nbkit/fixed_matrix.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+using nbkit::FixedMatrix;
+
+static_assert(sizeof(FixedMatrix<float, 3, 3>) == 9 * sizeof(float));
+static_assert(std::is_trivially_copyable_v<FixedMatrix<int, 4, 4>>);
+static_assert(FixedMatrix<int, 5, 2>::GetSizeX() == 5 && FixedMatrix<int, 5, 2>::GetSizeY() == 2);
+
+namespace
+{
+    // sum of the main diagonal, computed at compile time below
+    constexpr int GetTrace()
+    {
+        FixedMatrix<int, 3, 3> matrix({ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        matrix.Get(2, 2) = 10;
+
+        int trace = 0;
+        for (size_t i = 0; i < matrix.GetSizeX(); ++i)
+            trace += matrix.Get(i, i);
+        return trace;
+    }
+
+    // column and view walks, computed at compile time below
+    constexpr int GetColAndViewSums()
+    {
+        FixedMatrix<int, 3, 2> matrix({ 1, 2, 3, 4, 5, 6 });
+        for (int& value : matrix.Col(1))
+            value *= 10;
+
+        const auto& view_source = matrix;
+        int col_sum = 0;
+        for (int value : view_source.Col(1))
+            col_sum += value;
+
+        int view_sum = 0;
+        for (int value : view_source.AsView().SubMatrix(1, 0, 2, 2))
+            view_sum += value;
+        return col_sum * 1000 + view_sum;
+    }
+}
+
+static_assert(GetTrace() == 16);
+static_assert(GetColAndViewSums() == 70 * 1000 + 79);
+
+class FixedMatrixTest : public ::testing::Test
+{
+};
+
+TEST_F(FixedMatrixTest, DefaultIsValueInitialized)
+{
+    const FixedMatrix<int, 3, 2> matrix;
+
+    for (int value : matrix)
+        EXPECT_EQ(value, 0);
+}
+
+TEST_F(FixedMatrixTest, GetFollowsRowMajorInput)
+{
+    const FixedMatrix<int, 3, 2> matrix({ 0, 1, 2, 3, 4, 5 });
+
+    EXPECT_EQ(matrix.Get(0, 0), 0);
+    EXPECT_EQ(matrix.Get(2, 0), 2);
+    EXPECT_EQ(matrix.Get(0, 1), 3);
+    EXPECT_EQ(matrix.Get(2, 1), 5);
+}
+
+TEST_F(FixedMatrixTest, IteratorsWalkRowsInOrder)
+{
+    FixedMatrix<int, 4, 3> matrix;
+    std::iota(matrix.begin(), matrix.end(), 0);
+
+    EXPECT_EQ(matrix.end() - matrix.begin(), 12);
+    EXPECT_EQ(matrix.Get(1, 2), 9);
+    EXPECT_EQ(std::accumulate(matrix.begin(), matrix.end(), 0), 66);
+}
+
+TEST_F(FixedMatrixTest, RowAndColViews)
+{
+    FixedMatrix<int, 3, 3> matrix({ 0, 1, 2, 3, 4, 5, 6, 7, 8 });
+
+    const std::span<int, 3> row = matrix.Row(1);
+    EXPECT_EQ(std::vector<int>(row.begin(), row.end()), (std::vector<int>{ 3, 4, 5 }));
+
+    const auto col = matrix.Col(2);
+    EXPECT_EQ(std::vector<int>(col.begin(), col.end()), (std::vector<int>{ 2, 5, 8 }));
+
+    matrix.AsView().Get(1, 2) = 42;
+    EXPECT_EQ(matrix.Get(1, 2), 42);
+}
+
+TEST_F(FixedMatrixTest, FillAndCompare)
+{
+    FixedMatrix<int, 2, 2> a;
+    FixedMatrix<int, 2, 2> b({ 7, 7, 7, 7 });
+    EXPECT_NE(a, b);
+
+    a.Fill(7);
+    EXPECT_EQ(a, b);
+}
@@ -0,0 +1,129 @@
+#include "nbkit/log_async.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using nbkit::log::AsyncWriter;
+using nbkit::log::OStreamSink;
+using nbkit::log::QueueFullPolicy;
+using nbkit::log::RecordFormat;
+using nbkit::log::RecordInfo;
+
+namespace
+{
+    size_t CountLines(const std::string& str)
+    {
+        size_t lines = 0;
+        for (char c : str)
+            if (c == '\n')
+                ++lines;
+        return lines;
+    }
+}
+
+TEST(LogAsyncTest, FlushWritesDecoratedRecord)
+{
+    std::ostringstream out;
+    OStreamSink sink(out);
+    AsyncWriter<16> writer(sink, QueueFullPolicy::kBlock);
+
+    writer.Push("<c>", "</c>", "kDefault", "value=", 42, ' ', 1.5);
+    writer.Flush();
+
+    EXPECT_EQ(out.str(), "<c>[kDefault] value=42 1.5</c>\n");
+}
+
+TEST(LogAsyncTest, ColorsFollowTheSink)
+{
+    std::ostringstream out;
+    OStreamSink sink(out, false);
+    AsyncWriter<16> writer(sink, QueueFullPolicy::kBlock);
+
+    writer.Push("<c>", "</c>", "kDefault", "plain");
+    writer.Flush();
+
+    EXPECT_EQ(out.str(), "[kDefault] plain\n");
+}
+
+TEST(LogAsyncTest, StructuredFormatWritesJsonLines)
+{
+    std::ostringstream out;
+    OStreamSink sink(out);
+    AsyncWriter<16> writer(sink, QueueFullPolicy::kBlock, RecordFormat::kJson);
+
+    RecordInfo info;
+    info.level = "warning";
+    info.channel = "kDefault";
+    info.timestamp_ns = 5;
+    info.thread_id = 2;
+    writer.Push("<c>", "</c>", info, "value=", 42);
+    writer.Flush();
+
+    EXPECT_EQ(out.str(), "{\"ts\":5,\"level\":\"warning\",\"channel\":\"kDefault\",\"thread\":2,\"msg\":\"value=42\"}\n");
+}
+
+TEST(LogAsyncTest, LongMessagesAreTruncated)
+{
+    std::ostringstream out;
+    OStreamSink sink(out);
+    AsyncWriter<16> writer(sink, QueueFullPolicy::kBlock);
+
+    const std::string long_message(AsyncWriter<16>::kMaxTextSize * 2, 'x');
+    writer.Push("", "", "kDefault", long_message);
+    writer.Flush();
+
+    EXPECT_EQ(out.str(), "[kDefault] " + std::string(AsyncWriter<16>::kMaxTextSize, 'x') + "\n");
+}
+
+TEST(LogAsyncTest, BlockPolicyKeepsEveryRecord)
+{
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+
+    std::ostringstream out;
+
+    OStreamSink sink(out);
+    AsyncWriter<8> writer(sink, QueueFullPolicy::kBlock);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([&writer]() { for (int i = 0; i < kPerThread; ++i) writer.Push("", "", "kDefault", i); });
+    for (auto& thread : threads)
+        thread.join();
+
+    writer.Flush();
+    EXPECT_EQ(CountLines(out.str()), kThreads * kPerThread);
+    EXPECT_EQ(writer.GetDroppedCount(), 0);
+}
+
+TEST(LogAsyncTest, DropPolicyCountsDroppedRecords)
+{
+    constexpr int kRecords = 20000;
+
+    std::ostringstream out;
+
+    OStreamSink sink(out);
+    AsyncWriter<2> writer(sink, QueueFullPolicy::kDrop);
+
+    for (int i = 0; i < kRecords; ++i)
+        writer.Push("", "", "kDefault", i);
+
+    writer.Flush();
+    EXPECT_EQ(CountLines(out.str()) + writer.GetDroppedCount(), kRecords);
+}
+
+TEST(LogAsyncTest, ShutdownDrainsQueue)
+{
+    std::ostringstream out;
+    OStreamSink sink(out);
+    {
+        AsyncWriter<64> writer(sink, QueueFullPolicy::kBlock);
+        for (int i = 0; i < 50; ++i)
+            writer.Push("", "", "kDefault", i);
+    }
+
+    EXPECT_EQ(CountLines(out.str()), 50);
+}
@@ -0,0 +1,147 @@
+#include "nbkit/log_binary.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using nbkit::log::BinaryLogger;
+using nbkit::log::OStreamSink;
+using nbkit::log::QueueFullPolicy;
+
+namespace
+{
+    size_t CountLines(const std::string& str)
+    {
+        size_t lines = 0;
+        for (char c : str)
+            if (c == '\n')
+                ++lines;
+        return lines;
+    }
+}
+
+TEST(LogBinaryTest, NothingIsWrittenBeforeConsume)
+{
+    BinaryLogger logger;
+    const uint32_t site = logger.RegisterSite<int>("kDefault", "", "");
+    logger.Log(site, 1);
+
+    std::ostringstream out;
+    OStreamSink sink(out);
+    EXPECT_TRUE(out.str().empty());
+    logger.Consume(sink);
+    EXPECT_EQ(out.str(), "[kDefault] 1\n");
+}
+
+TEST(LogBinaryTest, DecodedTextMatchesStreaming)
+{
+    BinaryLogger logger;
+    const uint32_t site = logger.RegisterSite<const char*, int, char, double, bool, unsigned long, float>("kDefault", "<c>", "</c>");
+    logger.Log(site, "values ", -42, ' ', 3.25, true, 7ul, 0.5f);
+
+    std::ostringstream expected;
+    expected << "<c>[kDefault] " << "values " << -42 << ' ' << 3.25 << true << 7ul << 0.5f << "</c>\n";
+
+    std::ostringstream out;
+    OStreamSink sink(out);
+    logger.Consume(sink);
+    EXPECT_EQ(out.str(), expected.str());
+}
+
+TEST(LogBinaryTest, ColorsFollowTheSink)
+{
+    BinaryLogger logger;
+    const uint32_t site = logger.RegisterSite<int>("kDefault", "<c>", "</c>");
+    logger.Log(site, 1);
+
+    std::ostringstream out;
+    OStreamSink sink(out, false);
+    logger.Consume(sink);
+    EXPECT_EQ(out.str(), "[kDefault] 1\n");
+}
+
+TEST(LogBinaryTest, StringsAreCopied)
+{
+    BinaryLogger logger;
+    const uint32_t site = logger.RegisterSite<std::string, std::string_view, const char*>("kDefault", "", "");
+
+    {
+        std::string temporary = "first";
+        logger.Log(site, temporary, std::string_view("second"), static_cast<const char*>(nullptr));
+        temporary = "overwritten";
+    }
+
+    std::ostringstream out;
+    OStreamSink sink(out);
+    logger.Consume(sink);
+    EXPECT_EQ(out.str(), "[kDefault] firstsecond\n");
+}
+
+TEST(LogBinaryTest, RawDumpDecodesOffline)
+{
+    BinaryLogger logger;
+    const uint32_t site_a = logger.RegisterSite<int>("kA", "", "");
+    const uint32_t site_b = logger.RegisterSite<std::string_view, double>("kB", "", "");
+
+    std::stringstream raw;
+    logger.Log(site_a, 1);
+    logger.Log(site_b, std::string_view("x="), 2.5);
+    logger.ConsumeRaw(raw);
+
+    // sites already emitted are not repeated
+    logger.Log(site_a, 3);
+    logger.ConsumeRaw(raw);
+
+    std::ostringstream out;
+    EXPECT_TRUE(BinaryLogger::DecodeRaw(raw, out));
+    EXPECT_EQ(out.str(), "[kA] 1\n[kB] x=2.5\n[kA] 3\n");
+}
+
+TEST(LogBinaryTest, MalformedRawDumpFails)
+{
+    std::istringstream raw("Xgarbage");
+    std::ostringstream out;
+    EXPECT_FALSE(BinaryLogger::DecodeRaw(raw, out));
+}
+
+TEST(LogBinaryTest, FullBufferDropsWithoutFlushThread)
+{
+    BinaryLogger logger(64, QueueFullPolicy::kBlock);
+    const uint32_t site = logger.RegisterSite<int64_t>("kDefault", "", "");
+
+    // each record takes 16 bytes: 8 of header and 8 of payload
+    for (int i = 0; i < 10; ++i)
+        logger.Log(site, int64_t(i));
+
+    std::ostringstream out;
+    OStreamSink sink(out);
+    logger.Consume(sink);
+    EXPECT_EQ(CountLines(out.str()), 4);
+    EXPECT_EQ(logger.GetDroppedCount(), 6);
+}
+
+TEST(LogBinaryTest, FlushThreadConsumesEveryThread)
+{
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+
+    std::ostringstream out;
+    OStreamSink sink(out);
+    {
+        BinaryLogger logger(256, QueueFullPolicy::kBlock);
+        const uint32_t site = logger.RegisterSite<int, int>("kDefault", "", "");
+        logger.StartFlushThread(sink, std::chrono::milliseconds(1));
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+            threads.emplace_back([&logger, site, t]() { for (int i = 0; i < kPerThread; ++i) logger.Log(site, t, i); });
+        for (auto& thread : threads)
+            thread.join();
+
+        EXPECT_EQ(logger.GetDroppedCount(), 0);
+    }
+
+    EXPECT_EQ(CountLines(out.str()), kThreads * kPerThread);
+}
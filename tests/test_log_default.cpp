@@ -1,9 +1,13 @@
 #include "nbkit/log.h"
 
 #include <gtest/gtest.h>
+#include <functional>
 #include <sstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace nbkit::log;
 
@@ -28,6 +32,36 @@ namespace
             return oss.str();
         }
     };
+
+    // records every write call separately, so the test can check each record was written at once
+    class WriteRecorderBuf : public std::streambuf
+    {
+    private:
+        std::mutex mutex_;
+        std::vector<std::string> writes_;
+
+    public:
+        std::vector<std::string> GetWrites()
+        {
+            std::lock_guard lock(mutex_);
+            return writes_;
+        }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            std::lock_guard lock(mutex_);
+            writes_.emplace_back(1, traits_type::to_char_type(ch));
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize count) override
+        {
+            std::lock_guard lock(mutex_);
+            writes_.emplace_back(s, static_cast<size_t>(count));
+            return count;
+        }
+    };
 }
 
 TEST(LogDefaultTest, BasicLevelsPrint)
@@ -76,6 +110,27 @@ TEST(LogDefaultTest, AssertWarningAndErrorOnlyFireOnFailure)
     EXPECT_EQ(out.find("ASSERT_ERR_SHOULDNT_PRINT"), std::string::npos);
 }
 
+TEST(LogDefaultTest, AssertAcceptsBoolsAndSkipsDisabledChannels)
+{
+    CoutCapture capture;
+
+    int evaluations = 0;
+    AssertWarning(false, "ASSERT_BOOL");
+    AssertWarning(true, "ASSERT_BOOL_SHOULDNT_PRINT");
+    AssertError(std::function<bool()>([]() { return false; }), "ASSERT_FUNCTION");
+
+    DisableChannel(Channel::kDefault);
+    AssertError([&evaluations]() { ++evaluations; return false; }, "ASSERT_DISABLED");
+    ResetChannels();
+
+    const std::string out = capture.str();
+    EXPECT_NE(out.find("[kDefault] ASSERT_BOOL"), std::string::npos);
+    EXPECT_NE(out.find("[kDefault] ASSERT_FUNCTION"), std::string::npos);
+    EXPECT_EQ(out.find("ASSERT_BOOL_SHOULDNT_PRINT"), std::string::npos);
+    EXPECT_EQ(out.find("ASSERT_DISABLED"), std::string::npos);
+    EXPECT_EQ(evaluations, 0);
+}
+
 TEST(LogDefaultTest, ColorMarkersAndDefaultChannelEnabled)
 {
     CoutCapture capture;
@@ -87,3 +142,170 @@ TEST(LogDefaultTest, ColorMarkersAndDefaultChannelEnabled)
     EXPECT_NE(out.find(detail::kColorReset), std::string::npos);
     EXPECT_TRUE(IsChannelEnabled(Channel::kDefault));
 }
+
+TEST(LogDefaultTest, LazyArgsAreInvokedWhenLogging)
+{
+    CoutCapture capture;
+
+    int calls = 0;
+    Info("lazy=", [&calls]() { ++calls; return 42; });
+    NBKIT_LOG_WARNING(Channel::kDefault, "macro=", 7);
+
+    const std::string out = capture.str();
+    EXPECT_EQ(calls, 1);
+    EXPECT_NE(out.find("[kDefault] lazy=42"), std::string::npos);
+    EXPECT_NE(out.find("[kDefault] macro=7"), std::string::npos);
+}
+
+TEST(LogDefaultTest, AllLevelsEnabledByDefault)
+{
+    EXPECT_EQ(kMinLevel, Level::kVerbose);
+    EXPECT_TRUE(IsLevelEnabled(Level::kVerbose));
+    EXPECT_TRUE((IsEnabled<Channel::kDefault, Level::kVerbose>()));
+}
+
+TEST(LogDefaultTest, ChannelsCanBeToggledAtRuntime)
+{
+    CoutCapture capture;
+
+    EXPECT_TRUE(DisableChannel(Channel::kDefault));
+    EXPECT_FALSE(IsChannelEnabledRuntime(Channel::kDefault));
+    Info("DISABLED_TEMPLATE");
+    InfoRuntime(Channel::kDefault, "DISABLED_RUNTIME");
+
+    EXPECT_TRUE(EnableChannel(Channel::kDefault));
+    EXPECT_TRUE(IsChannelEnabledRuntime(Channel::kDefault));
+    Info("ENABLED_TEMPLATE");
+
+    DisableChannel(Channel::kDefault);
+    ResetChannels();
+    InfoRuntime(Channel::kDefault, "ENABLED_RUNTIME");
+
+    const std::string out = capture.str();
+    EXPECT_EQ(out.find("DISABLED_"), std::string::npos);
+    EXPECT_NE(out.find("ENABLED_TEMPLATE"), std::string::npos);
+    EXPECT_NE(out.find("ENABLED_RUNTIME"), std::string::npos);
+}
+
+TEST(LogDefaultTest, ConcurrentRecordsAreWrittenWhole)
+{
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 200;
+
+    WriteRecorderBuf recorder;
+    std::streambuf* old_buf = std::cout.rdbuf(&recorder);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([t]() { for (int i = 0; i < kPerThread; ++i) Info("thread ", t, " record ", i); });
+    for (auto& thread : threads)
+        thread.join();
+
+    std::cout.rdbuf(old_buf);
+
+    const std::vector<std::string> writes = recorder.GetWrites();
+    ASSERT_EQ(writes.size(), kThreads * kPerThread);
+    for (const std::string& write : writes)
+    {
+        EXPECT_EQ(write.rfind(detail::kColorInfo, 0), 0);
+        EXPECT_NE(write.find("[kDefault] thread "), std::string::npos);
+        EXPECT_EQ(write.back(), '\n');
+    }
+}
+
+namespace
+{
+    size_t CountOccurrences(const std::string& text, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+            ++count;
+        return count;
+    }
+}
+
+TEST(LogDefaultTest, EveryLogsOneCallInNAndReportsSuppressed)
+{
+    CoutCapture capture;
+
+    for (int i = 0; i < 7; ++i)
+        WarningEvery<3>("EVERY_", i);
+
+    const std::string out = capture.str();
+    EXPECT_EQ(CountOccurrences(out, "EVERY_"), 3);
+    EXPECT_NE(out.find("EVERY_0"), std::string::npos);
+    EXPECT_NE(out.find("EVERY_3"), std::string::npos);
+    EXPECT_NE(out.find("EVERY_6"), std::string::npos);
+    EXPECT_EQ(CountOccurrences(out, "2 messages suppressed"), 2);
+}
+
+TEST(LogDefaultTest, EveryKeepsStatePerCallSite)
+{
+    CoutCapture capture;
+
+    InfoEvery<100>("SITE_A");
+    InfoEvery<100>("SITE_B");
+
+    const std::string out = capture.str();
+    EXPECT_NE(out.find("SITE_A"), std::string::npos);
+    EXPECT_NE(out.find("SITE_B"), std::string::npos);
+}
+
+TEST(LogDefaultTest, SampledHonorsRateBounds)
+{
+    CoutCapture capture;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        InfoSampled(1.0, "ALWAYS");
+        InfoSampled(0.0, "NEVER");
+    }
+
+    const std::string out = capture.str();
+    EXPECT_EQ(CountOccurrences(out, "ALWAYS"), 10);
+    EXPECT_EQ(out.find("NEVER"), std::string::npos);
+}
+
+TEST(LogDefaultTest, RateLimitedSuppressesBursts)
+{
+    CoutCapture capture;
+
+    for (int i = 0; i < 1000; ++i)
+        ErrorRateLimited(1.0, "LIMITED");
+
+    const std::string out = capture.str();
+    EXPECT_EQ(CountOccurrences(out, "LIMITED"), 1);
+}
+
+TEST(LogDefaultTest, FlushReportsSuppressedAfterBurstStops)
+{
+    {
+        CoutCapture capture;
+        for (int i = 0; i < 5; ++i)
+            InfoEvery<10>("BURST");
+        EXPECT_EQ(capture.str().find("messages suppressed"), std::string::npos);
+
+        Flush();
+        EXPECT_EQ(CountOccurrences(capture.str(), "4 messages suppressed"), 1);
+    }
+
+    CoutCapture capture;
+    Flush();
+    EXPECT_EQ(capture.str().find("messages suppressed"), std::string::npos);
+}
+
+TEST(LogDefaultTest, FlushReportsCallSitesThatNeverLog)
+{
+    CoutCapture capture;
+
+    for (int i = 0; i < 3; ++i)
+        WarningSampled(0.0, "NEVER");
+    for (int i = 0; i < 4; ++i)
+        WarningRateLimited(0.0, "NEVER");
+    Flush();
+
+    const std::string out = capture.str();
+    EXPECT_EQ(out.find("NEVER"), std::string::npos);
+    EXPECT_EQ(CountOccurrences(out, "3 messages suppressed"), 1);
+    EXPECT_EQ(CountOccurrences(out, "4 messages suppressed"), 1);
+}
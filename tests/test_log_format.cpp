@@ -0,0 +1,57 @@
+#include "nbkit/log_format.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+using namespace nbkit::log;
+
+namespace
+{
+    RecordInfo MakeInfo(const char* file = nullptr, uint32_t line = 0)
+    {
+        RecordInfo info;
+        info.level = "info";
+        info.channel = "kDefault";
+        info.timestamp_ns = 1234;
+        info.thread_id = 7;
+        info.site = CallSite { file, line };
+        return info;
+    }
+}
+
+TEST(LogFormatTest, JsonRecordHasAllFields)
+{
+    std::string out;
+    detail::AppendStructuredRecord(out, RecordFormat::kJson, MakeInfo("main.cpp", 42), "hello");
+
+    EXPECT_EQ(out, "{\"ts\":1234,\"level\":\"info\",\"channel\":\"kDefault\",\"thread\":7,"
+                   "\"file\":\"main.cpp\",\"line\":42,\"msg\":\"hello\"}\n");
+}
+
+TEST(LogFormatTest, JsonEscapesMessage)
+{
+    std::string out;
+    detail::AppendStructuredRecord(out, RecordFormat::kJson, MakeInfo(), "a\"b\\c\nd\x01");
+
+    EXPECT_EQ(out, "{\"ts\":1234,\"level\":\"info\",\"channel\":\"kDefault\",\"thread\":7,"
+                   "\"msg\":\"a\\\"b\\\\c\\nd\\u0001\"}\n");
+}
+
+TEST(LogFormatTest, LogfmtQuotesOnlyWhenNeeded)
+{
+    std::string out;
+    detail::AppendStructuredRecord(out, RecordFormat::kLogfmt, MakeInfo("my file.cpp", 3), "x=1 y=2");
+
+    EXPECT_EQ(out, "ts=1234 level=info channel=kDefault thread=7 file=\"my file.cpp\" line=3 msg=\"x=1 y=2\"\n");
+}
+
+TEST(LogFormatTest, ThreadIdsAreStablePerThread)
+{
+    const uint32_t main_id = detail::GetLogThreadId();
+    uint32_t other_id = 0;
+    std::thread([&other_id]() { other_id = detail::GetLogThreadId(); }).join();
+
+    EXPECT_EQ(detail::GetLogThreadId(), main_id);
+    EXPECT_NE(other_id, main_id);
+}
@@ -0,0 +1,168 @@
+#include "nbkit/log.h"
+#include "nbkit/log_sinks.h"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace nbkit::log;
+
+namespace
+{
+    std::string ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+}
+
+class LogSinksTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path dir_;
+
+    void SetUp() override
+    {
+        const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        dir_ = std::filesystem::temp_directory_path() / (std::string("nbkit_log_sinks_") + test_info->name());
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directories(dir_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir_);
+    }
+};
+
+//-------------------------------------------------------- file sink
+
+TEST_F(LogSinksTest, FileSinkBuffersUntilFlush)
+{
+    const auto path = dir_ / "log.txt";
+    FileSink sink(path.string());
+    ASSERT_TRUE(sink.IsOpen());
+
+    sink.Write("line 1\n");
+    EXPECT_EQ(ReadFile(path), "");
+
+    sink.Flush();
+    EXPECT_EQ(ReadFile(path), "line 1\n");
+}
+
+TEST_F(LogSinksTest, FileSinkWritesWhenBufferIsFull)
+{
+    const auto path = dir_ / "log.txt";
+    FileSink sink(path.string(), true, 8);
+
+    sink.Write("12345\n");
+    sink.Write("67890\n");
+    EXPECT_EQ(ReadFile(path), "12345\n");
+
+    sink.Write(std::string(20, 'x'));
+    EXPECT_EQ(ReadFile(path), "12345\n67890\n" + std::string(20, 'x'));
+}
+
+TEST_F(LogSinksTest, FileSinkAppends)
+{
+    const auto path = dir_ / "log.txt";
+    {
+        FileSink sink(path.string());
+        sink.Write("first\n");
+    }
+    {
+        FileSink sink(path.string());
+        sink.Write("second\n");
+    }
+    EXPECT_EQ(ReadFile(path), "first\nsecond\n");
+}
+
+TEST_F(LogSinksTest, FileSinkOnBadPathDiscards)
+{
+    FileSink sink((dir_ / "missing_dir" / "log.txt").string());
+    EXPECT_FALSE(sink.IsOpen());
+    EXPECT_NO_THROW(sink.Write("ignored\n"));
+}
+
+TEST_F(LogSinksTest, LogThroughFileSinkHasNoColors)
+{
+    const auto path = dir_ / "log.txt";
+    FileSink sink(path.string());
+
+    // reports whatever earlier tests suppressed to the previous sink
+    Flush();
+    Sink& previous = GetSink();
+    SetSink(sink);
+    Info("to file ", 1);
+    Flush();
+    SetSink(previous);
+
+    EXPECT_EQ(ReadFile(path), "[kDefault] to file 1\n");
+}
+
+//-------------------------------------------------------- rotating file sink
+
+TEST_F(LogSinksTest, RotatingFileSinkRotates)
+{
+    const auto path = dir_ / "log.txt";
+    {
+        RotatingFileSink sink(path.string(), 10, 2);
+        sink.Write("aaaaaaaa\n");
+        sink.Write("bbbbbbbb\n");
+        sink.Write("cccccccc\n");
+        sink.Write("dddddddd\n");
+    }
+
+    EXPECT_EQ(ReadFile(path), "dddddddd\n");
+    EXPECT_EQ(ReadFile(path.string() + ".1"), "cccccccc\n");
+    EXPECT_EQ(ReadFile(path.string() + ".2"), "bbbbbbbb\n");
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".3"));
+}
+
+TEST_F(LogSinksTest, RotatingFileSinkKeepsSmallRecordsTogether)
+{
+    const auto path = dir_ / "log.txt";
+    {
+        RotatingFileSink sink(path.string(), 100, 1);
+        sink.Write("a\n");
+        sink.Write("b\n");
+    }
+
+    EXPECT_EQ(ReadFile(path), "a\nb\n");
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".1"));
+}
+
+//-------------------------------------------------------- mmap ring sink
+
+#ifdef NBKIT_LOG_HAS_MMAP_SINK
+TEST_F(LogSinksTest, MmapRingSinkKeepsContent)
+{
+    const auto path = dir_ / "ring.bin";
+    {
+        MmapRingSink sink(path.string(), 64);
+        ASSERT_TRUE(sink.IsOpen());
+        sink.Write("hello\n");
+        sink.Write("world\n");
+        EXPECT_EQ(MmapRingSink::ReadRing(path.string()), "hello\nworld\n");
+    }
+    EXPECT_EQ(MmapRingSink::ReadRing(path.string()), "hello\nworld\n");
+}
+
+TEST_F(LogSinksTest, MmapRingSinkOverwritesOldest)
+{
+    const auto path = dir_ / "ring.bin";
+    MmapRingSink sink(path.string(), 8);
+
+    sink.Write("0123");
+    sink.Write("4567");
+    sink.Write("89");
+    EXPECT_EQ(MmapRingSink::ReadRing(path.string()), "23456789");
+
+    sink.Write("abcdefghijkl");
+    EXPECT_EQ(MmapRingSink::ReadRing(path.string()), "efghijkl");
+}
+#endif
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <gtest/gtest.h>
 #include <numeric>
+#include <string>
 #include <vector>
 
 template<typename T>
@@ -66,6 +67,43 @@ TEST_F(MatrixTest, IncreaseSizeY)
     EXPECT_EQ(matrix.GetSizeY(), 4);
 }
 
+TEST_F(MatrixTest, IncreaseSizeYAfterShrinkValueInitializes)
+{
+    Matrix<int> matrix(4);
+    matrix.Resize(4, 4);
+    std::fill(matrix.begin(), matrix.end(), 7);
+
+    matrix.Resize(4, 1);
+    matrix.IncreaseSizeY();
+
+    EXPECT_EQ(matrix.GetSizeY(), 2);
+    for (size_t x = 0; x < 4; ++x)
+    {
+        EXPECT_EQ(matrix.Get(x, 0), 7);
+        EXPECT_EQ(matrix.Get(x, 1), 0);
+    }
+}
+
+TEST_F(MatrixTest, ZeroWidthMatrixHasNoRows)
+{
+    Matrix<int> matrix;
+    matrix.IncreaseSizeY();
+    EXPECT_EQ(matrix.GetSizeY(), 0);
+
+    matrix.Resize(0, 5);
+    EXPECT_EQ(matrix.GetSizeY(), 0);
+
+    const std::vector<int> row{1, 2, 3};
+    matrix.AppendRow(row);
+    EXPECT_EQ(matrix.GetSizeX(), 3);
+    EXPECT_EQ(matrix.GetSizeY(), 1);
+    EXPECT_EQ(matrix.Get(2, 0), 3);
+
+    matrix.Resize(0, 2);
+    EXPECT_EQ(matrix.GetSizeY(), 0);
+    EXPECT_EQ(matrix.begin(), matrix.end());
+}
+
 TEST_F(MatrixTest, Resize)
 {
     Matrix<int> matrix(2, std::vector<int>{0, 1, 2, 3});
@@ -77,6 +115,112 @@ TEST_F(MatrixTest, Resize)
     EXPECT_EQ(matrix.GetSizeY(), 4);
 }
 
+TEST_F(MatrixTest, ResizeWiderMovesRows)
+{
+    Matrix<int> matrix(3, std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    matrix.Resize(5, 3);
+
+    EXPECT_EQ(std::vector<int>(matrix.begin(), matrix.end()), (std::vector<int>{0, 1, 2, 0, 0, 3, 4, 5, 0, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST_F(MatrixTest, ResizeNarrowerMovesRows)
+{
+    Matrix<int> matrix(3, std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    matrix.Resize(2, 3);
+
+    EXPECT_EQ(std::vector<int>(matrix.begin(), matrix.end()), (std::vector<int>{0, 1, 3, 4, 0, 0}));
+}
+
+TEST_F(MatrixTest, ResizeMovesNonTrivialElements)
+{
+    Matrix<std::string> matrix(2, std::vector<std::string>{"a", "b", "c", "d"});
+
+    matrix.Resize(3, 2);
+    EXPECT_EQ(std::vector<std::string>(matrix.begin(), matrix.end()), (std::vector<std::string>{"a", "b", "", "c", "d", ""}));
+
+    matrix.Resize(1, 2);
+    EXPECT_EQ(std::vector<std::string>(matrix.begin(), matrix.end()), (std::vector<std::string>{"a", "c"}));
+}
+
+TEST_F(MatrixTest, ResizeUninitializedKeepsElements)
+{
+    Matrix<int> matrix(3, std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    matrix.ResizeUninitialized(4, 3);
+
+    EXPECT_EQ(matrix.GetSizeX(), 4);
+    EXPECT_EQ(matrix.GetSizeY(), 3);
+    EXPECT_EQ(matrix.Get(2, 0), 2);
+    EXPECT_EQ(matrix.Get(0, 1), 3);
+    EXPECT_EQ(matrix.Get(2, 1), 5);
+}
+
+//-------------------------------------------------------- row growth
+
+TEST_F(MatrixTest, AppendRowSetsWidthOfEmptyMatrix)
+{
+    Matrix<int> matrix;
+    const std::vector<int> first{1, 2, 3};
+    const std::vector<int> second{4, 5, 6};
+
+    matrix.AppendRow(first);
+    matrix.AppendRow(second);
+
+    EXPECT_EQ(matrix.GetSizeX(), 3);
+    EXPECT_EQ(matrix.GetSizeY(), 2);
+    EXPECT_EQ(std::vector<int>(matrix.begin(), matrix.end()), (std::vector<int>{1, 2, 3, 4, 5, 6}));
+}
+
+TEST_F(MatrixTest, EmplaceRowConstructsEachElement)
+{
+    Matrix<std::string> matrix(2);
+
+    matrix.EmplaceRow(3, 'x');
+
+    EXPECT_EQ(matrix.GetSizeY(), 2);
+    EXPECT_EQ(matrix.Get(0, 0), "");
+    EXPECT_EQ(matrix.Get(0, 1), "xxx");
+    EXPECT_EQ(matrix.Get(1, 1), "xxx");
+}
+
+TEST_F(MatrixTest, AppendRowOfItsOwnRow)
+{
+    Matrix<std::string> matrix(3, std::vector<std::string>{"a", "b", "c"});
+
+    // each append reallocates while the source row is in the old storage
+    for (size_t y = 0; y < 6; ++y)
+        matrix.AppendRow(matrix.Row(y));
+
+    EXPECT_EQ(matrix.GetSizeY(), 7);
+    EXPECT_EQ(matrix.Get(2, 6), "c");
+}
+
+TEST_F(MatrixTest, EmplaceRowFromItsOwnElement)
+{
+    Matrix<std::string> matrix(2, std::vector<std::string>{"x", "y"});
+
+    for (size_t y = 0; y < 6; ++y)
+        matrix.EmplaceRow(matrix.Get(1, y));
+
+    EXPECT_EQ(matrix.GetSizeY(), 7);
+    EXPECT_EQ(matrix.Get(0, 6), "y");
+}
+
+TEST_F(MatrixTest, ReserveRowsKeepsStorage)
+{
+    Matrix<int> matrix(4);
+    matrix.ReserveRows(100);
+    const int* data = matrix.GetData();
+
+    for (int i = 1; i < 100; ++i)
+        matrix.EmplaceRow(i);
+
+    EXPECT_EQ(matrix.GetData(), data);
+    EXPECT_EQ(matrix.Get(3, 99), 99);
+}
+
 //-------------------------------------------------------- clear
 
 TEST_F(MatrixTest, Clear)
@@ -618,4 +762,131 @@ TEST_F(MatrixTest, FloatMatrix)
     Matrix<float> matrix(2, std::vector<float>{1.5f, 2.5f, 3.5f, 4.5f});
     EXPECT_FLOAT_EQ(matrix.Get(0, 0), 1.5f);
     EXPECT_FLOAT_EQ(matrix.Get(1, 1), 4.5f);
-}
\ No newline at end of file
+}
+//-------------------------------------------------------- layouts
+
+template <typename Layout>
+class MatrixLayoutTypedTest : public ::testing::Test
+{
+};
+
+using MatrixLayouts = ::testing::Types<nbkit::RowMajorLayout, nbkit::PaddedLayout<4>, nbkit::TiledLayout<4, 2>, nbkit::MortonLayout<4>>;
+TYPED_TEST_SUITE(MatrixLayoutTypedTest, MatrixLayouts);
+
+TYPED_TEST(MatrixLayoutTypedTest, GetFollowsRowMajorInput)
+{
+    const nbkit::Matrix<int, TypeParam> matrix(5, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+
+    EXPECT_EQ(matrix.GetSizeX(), 5);
+    EXPECT_EQ(matrix.GetSizeY(), 3);
+    for (size_t y = 0; y < 3; ++y)
+        for (size_t x = 0; x < 5; ++x)
+            EXPECT_EQ(matrix.Get(x, y), static_cast<int>(y * 5 + x));
+}
+
+TYPED_TEST(MatrixLayoutTypedTest, IteratorsWalkRowsInOrder)
+{
+    std::vector<int> vec(7 * 5);
+    std::iota(vec.begin(), vec.end(), 0);
+    nbkit::Matrix<int, TypeParam> matrix(7, vec);
+
+    EXPECT_EQ(std::vector<int>(matrix.begin(), matrix.end()), vec);
+    EXPECT_EQ(matrix.end() - matrix.begin(), 35);
+    EXPECT_EQ(*(matrix.begin() + 9), 9);
+    EXPECT_EQ(*(--matrix.end()), 34);
+
+    const auto& const_matrix = matrix;
+    EXPECT_EQ(std::accumulate(const_matrix.begin(), const_matrix.end(), 0), 34 * 35 / 2);
+}
+
+TYPED_TEST(MatrixLayoutTypedTest, IncreaseSizeYKeepsData)
+{
+    nbkit::Matrix<int, TypeParam> matrix(3);
+    matrix.Get(2, 0) = 7;
+
+    for (int i = 0; i < 4; ++i)
+        matrix.IncreaseSizeY();
+    matrix.Get(1, 4) = 9;
+
+    EXPECT_EQ(matrix.GetSizeY(), 5);
+    EXPECT_EQ(matrix.Get(2, 0), 7);
+    EXPECT_EQ(matrix.Get(1, 4), 9);
+}
+
+TYPED_TEST(MatrixLayoutTypedTest, AppendRowKeepsData)
+{
+    nbkit::Matrix<int, TypeParam> matrix;
+    for (int y = 0; y < 9; ++y)
+    {
+        const std::vector<int> row{y * 3, y * 3 + 1, y * 3 + 2};
+        matrix.AppendRow(row);
+    }
+
+    std::vector<int> expected(27);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(matrix.GetSizeY(), 9);
+    EXPECT_EQ(std::vector<int>(matrix.begin(), matrix.end()), expected);
+}
+
+TYPED_TEST(MatrixLayoutTypedTest, ResizeWidthKeepsPositions)
+{
+    std::vector<int> vec(5 * 4);
+    std::iota(vec.begin(), vec.end(), 1);
+    nbkit::Matrix<int, TypeParam> matrix(5, vec);
+
+    matrix.Resize(7, 5);
+    for (size_t y = 0; y < 5; ++y)
+        for (size_t x = 0; x < 7; ++x)
+            EXPECT_EQ(matrix.Get(x, y), x < 5 && y < 4 ? static_cast<int>(y * 5 + x + 1) : 0);
+
+    matrix.Resize(2, 3);
+    for (size_t y = 0; y < 3; ++y)
+        for (size_t x = 0; x < 2; ++x)
+            EXPECT_EQ(matrix.Get(x, y), static_cast<int>(y * 5 + x + 1));
+}
+
+TYPED_TEST(MatrixLayoutTypedTest, ResizeHeightBackValueInitializes)
+{
+    nbkit::Matrix<int, TypeParam> matrix;
+    matrix.Resize(4, 4);
+    std::fill(matrix.begin(), matrix.end(), 7);
+
+    matrix.Resize(4, 1);
+    matrix.Resize(4, 4);
+
+    for (size_t y = 0; y < 4; ++y)
+        for (size_t x = 0; x < 4; ++x)
+            EXPECT_EQ(matrix.Get(x, y), y == 0 ? 7 : 0);
+}
+
+TEST_F(MatrixTest, TiledResizeMovesElements)
+{
+    nbkit::Matrix<int, nbkit::TiledLayout<4, 4>> matrix(3, std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    matrix.Resize(6, 3);
+
+    EXPECT_EQ(matrix.GetSizeX(), 6);
+    EXPECT_EQ(matrix.GetSizeY(), 3);
+    EXPECT_EQ(matrix.Get(2, 0), 2);
+    EXPECT_EQ(matrix.Get(0, 1), 3);
+    EXPECT_EQ(matrix.Get(2, 1), 5);
+}
+
+//-------------------------------------------------------- unchecked access
+
+TEST_F(MatrixTest, RowPtrPointsAtRowStart)
+{
+    Matrix<int> matrix(3, std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    EXPECT_EQ(matrix.RowPtr(0), matrix.GetData());
+    EXPECT_EQ(matrix.RowPtr(1), &matrix.Get(0, 1));
+    EXPECT_EQ(matrix.RowPtr(1)[2], 5);
+}
+
+TEST_F(MatrixTest, RowPtrFollowsPaddedStride)
+{
+    nbkit::Matrix<int, nbkit::PaddedLayout<4>> matrix(3, std::vector<int>{0, 1, 2, 3, 4, 5});
+
+    EXPECT_EQ(matrix.RowPtr(1) - matrix.RowPtr(0), 4);
+    EXPECT_EQ(matrix.RowPtr(1)[1], 4);
+}
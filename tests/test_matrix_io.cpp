@@ -0,0 +1,190 @@
+#include "nbkit/matrix_io.h"
+
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using nbkit::MapMode;
+using nbkit::MappedMatrix;
+using nbkit::Matrix;
+
+namespace
+{
+    template <typename Layout = nbkit::RowMajorLayout>
+    Matrix<float, Layout> MakeMatrix(size_t width, size_t height)
+    {
+        std::vector<float> values(width * height);
+        std::iota(values.begin(), values.end(), 0.5f);
+        return Matrix<float, Layout>(width, values);
+    }
+
+    // stream buffer that can't seek, like a pipe
+    class ForwardOnlyBuffer : public std::streambuf
+    {
+        std::string bytes_;
+
+    public:
+        explicit ForwardOnlyBuffer(std::string bytes) : bytes_(std::move(bytes)) { setg(bytes_.data(), bytes_.data(), bytes_.data() + bytes_.size()); }
+    };
+
+    std::string SetHeaderField(std::string bytes, size_t offset, uint64_t value)
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+        return bytes;
+    }
+}
+
+class MatrixIoTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path path_ = std::filesystem::temp_directory_path() /
+        ("nbkit_matrix_io_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+         ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".nbm");
+
+    void TearDown() override { std::filesystem::remove(path_); }
+};
+
+TEST_F(MatrixIoTest, StreamRoundTripAcrossLayouts)
+{
+    const auto original = MakeMatrix<nbkit::PaddedLayout<8>>(5, 4);
+
+    std::stringstream stream;
+    ASSERT_TRUE(nbkit::SaveMatrix(original, stream));
+
+    Matrix<float> row_major;
+    ASSERT_TRUE(nbkit::LoadMatrix(stream, row_major));
+    stream.seekg(0);
+    Matrix<float, nbkit::TiledLayout<4, 4>> tiled;
+    ASSERT_TRUE(nbkit::LoadMatrix(stream, tiled));
+
+    ASSERT_EQ(row_major.GetSizeX(), 5);
+    ASSERT_EQ(row_major.GetSizeY(), 4);
+    for (size_t y = 0; y < 4; ++y)
+        for (size_t x = 0; x < 5; ++x)
+        {
+            EXPECT_EQ(row_major.Get(x, y), original.Get(x, y));
+            EXPECT_EQ(tiled.Get(x, y), original.Get(x, y));
+        }
+}
+
+TEST_F(MatrixIoTest, LoadRejectsOtherElementTypesAndGarbage)
+{
+    std::stringstream stream;
+    ASSERT_TRUE(nbkit::SaveMatrix(MakeMatrix(3, 3), stream));
+
+    Matrix<int32_t> ints;
+    EXPECT_FALSE(nbkit::LoadMatrix(stream, ints));
+
+    std::stringstream garbage(std::string(100, 'x'));
+    Matrix<float> floats;
+    EXPECT_FALSE(nbkit::LoadMatrix(garbage, floats));
+
+    // truncated data
+    std::string bytes = stream.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 4));
+    EXPECT_FALSE(nbkit::LoadMatrix(truncated, floats));
+}
+
+TEST_F(MatrixIoTest, MappedMatrixReadsFileInPlace)
+{
+    const auto original = MakeMatrix<nbkit::CacheLinePaddedLayout<float>>(21, 7);
+    ASSERT_TRUE(nbkit::SaveMatrix(original, path_));
+
+    MappedMatrix<float> mapped;
+    ASSERT_TRUE(mapped.Open(path_));
+
+    EXPECT_EQ(mapped.GetSizeX(), 21);
+    EXPECT_EQ(mapped.GetSizeY(), 7);
+    EXPECT_EQ(mapped.GetRowStride(), 32);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.GetData()) % 64, 0);
+    for (size_t y = 0; y < 7; ++y)
+        for (size_t x = 0; x < 21; ++x)
+            EXPECT_EQ(mapped.Get(x, y), original.Get(x, y));
+
+    const auto column = mapped.AsView().Col(3);
+    EXPECT_EQ(column[6], original.Get(3, 6));
+
+    MappedMatrix<double> wrong_type;
+    EXPECT_FALSE(wrong_type.Open(path_));
+}
+
+TEST_F(MatrixIoTest, ReadWriteMappingUpdatesFile)
+{
+    ASSERT_TRUE(nbkit::SaveMatrix(MakeMatrix(4, 4), path_));
+    {
+        MappedMatrix<float> mapped;
+        ASSERT_TRUE(mapped.Open(path_, MapMode::kReadWrite));
+        ASSERT_TRUE(mapped.IsWritable());
+
+        MappedMatrix<float> moved = std::move(mapped);
+        EXPECT_FALSE(mapped.IsOpen());
+        moved.AsMutableView().Get(2, 3) = 42.f;
+    }
+
+    Matrix<float> loaded;
+    ASSERT_TRUE(nbkit::LoadMatrix(path_, loaded));
+    EXPECT_EQ(loaded.Get(2, 3), 42.f);
+    EXPECT_EQ(loaded.Get(1, 3), 13.5f);
+}
+
+TEST_F(MatrixIoTest, MappedMatrixRejectsTruncatedFile)
+{
+    ASSERT_TRUE(nbkit::SaveMatrix(MakeMatrix(16, 16), path_));
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 1);
+
+    MappedMatrix<float> mapped;
+    EXPECT_FALSE(mapped.Open(path_));
+    EXPECT_FALSE(mapped.Open(path_.string() + ".missing"));
+}
+
+TEST_F(MatrixIoTest, LoadReadsStreamsThatCantSeek)
+{
+    const auto original = MakeMatrix(7, 5);
+    std::stringstream stream;
+    ASSERT_TRUE(nbkit::SaveMatrix(original, stream));
+
+    ForwardOnlyBuffer buffer(stream.str());
+    std::istream in(&buffer);
+    Matrix<float> loaded;
+    ASSERT_TRUE(nbkit::LoadMatrix(in, loaded));
+
+    EXPECT_EQ(std::vector<float>(loaded.begin(), loaded.end()), std::vector<float>(original.begin(), original.end()));
+}
+
+TEST_F(MatrixIoTest, LoadRejectsCorruptSizesWithoutAllocating)
+{
+    std::stringstream stream;
+    ASSERT_TRUE(nbkit::SaveMatrix(MakeMatrix(4, 4), stream));
+    const std::string bytes = stream.str();
+    const size_t height_offset = offsetof(nbkit::MatrixFileHeader, height);
+    const size_t data_offset_offset = offsetof(nbkit::MatrixFileHeader, data_offset);
+
+    for (const std::string& corrupt : { SetHeaderField(bytes, height_offset, uint64_t { 1 } << 40),
+                                        SetHeaderField(bytes, data_offset_offset, UINT64_MAX - 16) })
+    {
+        Matrix<float> loaded;
+        std::stringstream seekable(corrupt);
+        EXPECT_FALSE(nbkit::LoadMatrix(seekable, loaded));
+
+        ForwardOnlyBuffer buffer(corrupt);
+        std::istream forward_only(&buffer);
+        EXPECT_FALSE(nbkit::LoadMatrix(forward_only, loaded));
+    }
+}
+
+TEST_F(MatrixIoTest, MappedMatrixRejectsDataOffsetOverflow)
+{
+    std::stringstream stream;
+    ASSERT_TRUE(nbkit::SaveMatrix(MakeMatrix(4, 4), stream));
+    {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out << SetHeaderField(stream.str(), offsetof(nbkit::MatrixFileHeader, data_offset), UINT64_MAX - 63);
+    }
+
+    MappedMatrix<float> mapped;
+    EXPECT_FALSE(mapped.Open(path_));
+}
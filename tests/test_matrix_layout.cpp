@@ -0,0 +1,85 @@
+#include "nbkit/matrix_layout.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::MortonLayout;
+using nbkit::PaddedLayout;
+using nbkit::RowMajorLayout;
+using nbkit::TiledLayout;
+
+namespace
+{
+    // every element must get its own index inside the storage
+    template <typename Layout>
+    void ExpectIndicesAreUnique(size_t width, size_t height)
+    {
+        const size_t storage_size = Layout::GetStorageSize(width, height);
+        std::vector<bool> used(storage_size, false);
+
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                const size_t index = Layout::GetIndex(x, y, width);
+                ASSERT_LT(index, storage_size);
+                EXPECT_FALSE(used[index]) << "x=" << x << " y=" << y;
+                used[index] = true;
+            }
+        }
+    }
+}
+
+TEST(MatrixLayoutTest, RowMajorIndices)
+{
+    EXPECT_EQ(RowMajorLayout::GetStorageSize(3, 2), 6);
+    EXPECT_EQ(RowMajorLayout::GetIndex(2, 1, 3), 5);
+    ExpectIndicesAreUnique<RowMajorLayout>(7, 5);
+}
+
+TEST(MatrixLayoutTest, PaddedIndices)
+{
+    using Layout = PaddedLayout<8>;
+
+    EXPECT_EQ(Layout::GetRowStride(5), 8);
+    EXPECT_EQ(Layout::GetRowStride(16), 16);
+    EXPECT_EQ(Layout::GetStorageSize(5, 3), 24);
+    EXPECT_EQ(Layout::GetIndex(2, 1, 5), 10);
+    EXPECT_EQ(nbkit::CacheLinePaddedLayout<double>::GetRowStride(9), 16);
+    ExpectIndicesAreUnique<Layout>(13, 4);
+}
+
+TEST(MatrixLayoutTest, TiledIndices)
+{
+    using Layout = TiledLayout<4, 2>;
+
+    // 5x3 needs 2x2 tiles of 8 elements
+    EXPECT_EQ(Layout::GetStorageSize(5, 3), 32);
+    EXPECT_EQ(Layout::GetIndex(0, 0, 5), 0);
+    EXPECT_EQ(Layout::GetIndex(3, 1, 5), 7);
+    EXPECT_EQ(Layout::GetIndex(4, 0, 5), 8);
+    EXPECT_EQ(Layout::GetIndex(0, 2, 5), 16);
+    ExpectIndicesAreUnique<Layout>(13, 9);
+}
+
+TEST(MatrixLayoutTest, MortonIndices)
+{
+    using Layout = MortonLayout<4>;
+
+    EXPECT_EQ(Layout::GetStorageSize(5, 3), 32);
+    EXPECT_EQ(Layout::GetIndex(1, 0, 4), 1);
+    EXPECT_EQ(Layout::GetIndex(0, 1, 4), 2);
+    EXPECT_EQ(Layout::GetIndex(1, 1, 4), 3);
+    EXPECT_EQ(Layout::GetIndex(2, 0, 4), 4);
+    EXPECT_EQ(Layout::GetIndex(3, 3, 4), 15);
+    ExpectIndicesAreUnique<Layout>(13, 9);
+}
+
+TEST(MatrixLayoutTest, TiledNeighboursShareTile)
+{
+    using Layout = TiledLayout<64, 64>;
+    constexpr size_t kWidth = 4096;
+
+    // the element below is 64 elements away instead of a full row
+    EXPECT_EQ(Layout::GetIndex(10, 11, kWidth) - Layout::GetIndex(10, 10, kWidth), 64);
+}
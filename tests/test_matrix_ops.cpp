@@ -0,0 +1,154 @@
+#include "nbkit/matrix_ops.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::Matrix;
+namespace matrix_ops = nbkit::matrix_ops;
+
+class MatrixOpsTest : public ::testing::Test
+{
+protected:
+    // 5x3 so that rows don't line up with the vector widths
+    Matrix<float> a_ { 5, std::vector<float>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 } };
+    Matrix<float> b_ { 5, std::vector<float>(15, 2.f) };
+};
+
+TEST_F(MatrixOpsTest, ElementwiseResizesOutput)
+{
+    Matrix<float> out;
+
+    matrix_ops::Add(a_, b_, out);
+    EXPECT_EQ(out.GetSizeX(), 5);
+    EXPECT_EQ(out.GetSizeY(), 3);
+    EXPECT_EQ(out.Get(4, 2), 17.f);
+
+    matrix_ops::MultiplyAdd(a_, b_, b_, out);
+    EXPECT_EQ(out.Get(1, 1), 16.f);
+
+    matrix_ops::Clamp(a_, 4.f, 9.f, out);
+    EXPECT_EQ(out.Get(0, 0), 4.f);
+    EXPECT_EQ(out.Get(2, 1), 8.f);
+    EXPECT_EQ(out.Get(4, 2), 9.f);
+}
+
+TEST_F(MatrixOpsTest, OutputCanAliasInput)
+{
+    matrix_ops::Scale(a_, 2.f, a_);
+
+    EXPECT_EQ(a_.Get(0, 0), 2.f);
+    EXPECT_EQ(a_.Get(4, 2), 30.f);
+}
+
+TEST_F(MatrixOpsTest, Reductions)
+{
+    EXPECT_EQ(matrix_ops::Sum(a_), 120.f);
+    EXPECT_EQ(matrix_ops::Min(a_), 1.f);
+    EXPECT_EQ(matrix_ops::Max(a_), 15.f);
+    EXPECT_EQ(matrix_ops::Dot(a_, b_), 240.f);
+}
+
+TEST(MatrixOpsIntTest, ReductionsOnIntegers)
+{
+    Matrix<int32_t> matrix { 3, std::vector<int32_t>{ -4, 7, 2, 9, -11, 0 } };
+
+    EXPECT_EQ(matrix_ops::Sum(matrix), 3);
+    EXPECT_EQ(matrix_ops::Min(matrix), -11);
+    EXPECT_EQ(matrix_ops::Max(matrix), 9);
+}
+
+namespace
+{
+    template <typename T>
+    Matrix<T> MakeMatrix(size_t width, size_t height, int seed)
+    {
+        Matrix<T> matrix;
+        matrix.Resize(width, height);
+        for (size_t y = 0; y < height; ++y)
+            for (size_t x = 0; x < width; ++x)
+                matrix.Get(x, y) = static_cast<T>(static_cast<int>((x * 7 + y * 13 + seed) % 19) - 9);
+        return matrix;
+    }
+
+    template <typename T>
+    Matrix<T> MultiplyNaive(const Matrix<T>& a, const Matrix<T>& b)
+    {
+        Matrix<T> out;
+        out.Resize(b.GetSizeX(), a.GetSizeY());
+        for (size_t y = 0; y < a.GetSizeY(); ++y)
+            for (size_t x = 0; x < b.GetSizeX(); ++x)
+            {
+                T sum {};
+                for (size_t k = 0; k < a.GetSizeX(); ++k)
+                    sum += a.Get(k, y) * b.Get(x, k);
+                out.Get(x, y) = sum;
+            }
+        return out;
+    }
+}
+
+TEST(MatrixOpsLinearTest, MultiplySmall)
+{
+    // 2x3 by 3x2
+    Matrix<float> a { 3, std::vector<float>{ 1, 2, 3, 4, 5, 6 } };
+    Matrix<float> b { 2, std::vector<float>{ 7, 8, 9, 10, 11, 12 } };
+
+    const Matrix<float> out = matrix_ops::Multiply(a, b);
+
+    EXPECT_EQ(out.GetSizeX(), 2);
+    EXPECT_EQ(out.GetSizeY(), 2);
+    EXPECT_EQ(std::vector<float>(out.begin(), out.end()), (std::vector<float>{ 58, 64, 139, 154 }));
+}
+
+TEST(MatrixOpsLinearTest, MultiplyMatchesNaiveAcrossBlocks)
+{
+    // odd sizes leave partial tiles, depth and columns cross the 256 and 2048 blocks
+    const auto a = MakeMatrix<int32_t>(300, 13, 1);
+    const auto b = MakeMatrix<int32_t>(2050, 300, 2);
+
+    const auto expected = MultiplyNaive(a, b);
+    const auto out = matrix_ops::Multiply(a, b);
+
+    EXPECT_EQ(std::vector<int32_t>(out.begin(), out.end()), std::vector<int32_t>(expected.begin(), expected.end()));
+}
+
+TEST(MatrixOpsLinearTest, MultiplyFloatsAreExactOnSmallIntegers)
+{
+    const auto a = MakeMatrix<float>(37, 41, 3);
+    const auto b = MakeMatrix<float>(29, 37, 4);
+
+    const auto expected = MultiplyNaive(a, b);
+    const auto out = matrix_ops::Multiply(a, b);
+
+    EXPECT_EQ(std::vector<float>(out.begin(), out.end()), std::vector<float>(expected.begin(), expected.end()));
+}
+
+TEST(MatrixOpsLinearTest, Transpose)
+{
+    const auto a = MakeMatrix<int>(70, 45, 5);
+
+    const Matrix<int> out = matrix_ops::Transpose(a);
+
+    ASSERT_EQ(out.GetSizeX(), 45);
+    ASSERT_EQ(out.GetSizeY(), 70);
+    for (size_t y = 0; y < 45; ++y)
+        for (size_t x = 0; x < 70; ++x)
+            EXPECT_EQ(out.Get(y, x), a.Get(x, y));
+}
+
+TEST(MatrixOpsLinearTest, TransposeInPlace)
+{
+    for (const auto& [width, height] : { std::pair<size_t, size_t>{ 70, 70 }, std::pair<size_t, size_t>{ 33, 5 } })
+    {
+        const auto original = MakeMatrix<int>(width, height, 6);
+        auto matrix = original;
+
+        matrix_ops::TransposeInPlace(matrix);
+
+        ASSERT_EQ(matrix.GetSizeX(), height);
+        ASSERT_EQ(matrix.GetSizeY(), width);
+        for (size_t y = 0; y < height; ++y)
+            for (size_t x = 0; x < width; ++x)
+                EXPECT_EQ(matrix.Get(y, x), original.Get(x, y));
+    }
+}
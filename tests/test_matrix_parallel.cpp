@@ -0,0 +1,123 @@
+#include "nbkit/matrix_parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::Matrix;
+using nbkit::ThreadPool;
+namespace matrix_ops = nbkit::matrix_ops;
+
+namespace
+{
+    Matrix<float> MakeMatrix(size_t width, size_t height)
+    {
+        Matrix<float> matrix;
+        matrix.Resize(width, height);
+        for (size_t y = 0; y < height; ++y)
+            for (size_t x = 0; x < width; ++x)
+                matrix.Get(x, y) = 1.f / static_cast<float>(1 + (x * 7 + y * 13) % 101);
+        return matrix;
+    }
+}
+
+TEST(MatrixParallelTest, ForEachRowVisitsEveryRowOnce)
+{
+    ThreadPool pool(3);
+    Matrix<int> matrix;
+    matrix.Resize(37, 1500);
+
+    matrix_ops::ParallelForEachRow(matrix, [](size_t y, std::span<int> row)
+    {
+        for (int& value : row)
+            value += static_cast<int>(y);
+    }, pool);
+
+    for (size_t y = 0; y < matrix.GetSizeY(); ++y)
+    {
+        EXPECT_EQ(matrix.Get(0, y), static_cast<int>(y));
+        EXPECT_EQ(matrix.Get(36, y), static_cast<int>(y));
+    }
+}
+
+TEST(MatrixParallelTest, TransformResizesAndConverts)
+{
+    ThreadPool pool(3);
+    Matrix<int> a { 3, std::vector<int>(300000, 0) };
+    for (size_t i = 0; i < 300000; ++i)
+        a.GetData()[i] = static_cast<int>(i);
+
+    Matrix<double> out;
+    matrix_ops::ParallelTransform(a, out, [](int value) { return value * 0.5; }, pool);
+
+    ASSERT_EQ(out.GetSizeX(), 3);
+    ASSERT_EQ(out.GetSizeY(), 100000);
+    for (size_t i = 0; i < 300000; i += 997)
+        EXPECT_EQ(out.GetData()[i], static_cast<double>(i) * 0.5);
+}
+
+TEST(MatrixParallelTest, ReduceIsDeterministicAcrossThreadCounts)
+{
+    const auto matrix = MakeMatrix(1000, 700);
+    const auto plus = [](float a, float b) { return a + b; };
+
+    ThreadPool serial(0);
+    const float expected = matrix_ops::ParallelReduce(matrix, 0.f, plus, serial);
+
+    for (size_t threads : { 1, 3, 7 })
+    {
+        ThreadPool pool(threads);
+        for (int repeat = 0; repeat < 5; ++repeat)
+        {
+            const float sum = matrix_ops::ParallelReduce(matrix, 0.f, plus, pool);
+            EXPECT_EQ(std::memcmp(&sum, &expected, sizeof(float)), 0) << threads << " threads";
+        }
+    }
+}
+
+TEST(MatrixParallelTest, ReduceToOtherType)
+{
+    Matrix<int> matrix { 4, std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8 } };
+
+    const auto count_even = [](size_t count, auto value)
+    {
+        if constexpr (std::is_same_v<decltype(value), int>)
+            return count + (value % 2 == 0 ? 1 : 0);
+        else
+            return count + value;
+    };
+
+    EXPECT_EQ(matrix_ops::ParallelReduce(matrix, size_t { 0 }, count_even), 4);
+}
+
+TEST(MatrixParallelTest, ReduceToBool)
+{
+    ThreadPool pool(3);
+    Matrix<int> matrix;
+    matrix.Resize(1024, 512);
+    std::fill(matrix.begin(), matrix.end(), 1);
+    matrix.Get(1000, 500) = -1;
+
+    const auto any_negative = [](bool found, auto value)
+    {
+        if constexpr (std::is_same_v<decltype(value), bool>)
+            return found || value;
+        else
+            return found || value < 0;
+    };
+    const auto all_positive = [](bool all, auto value)
+    {
+        if constexpr (std::is_same_v<decltype(value), bool>)
+            return all && value;
+        else
+            return all && value > 0;
+    };
+
+    EXPECT_TRUE(matrix_ops::ParallelReduce(matrix, false, any_negative, pool));
+    EXPECT_FALSE(matrix_ops::ParallelReduce(matrix, true, all_positive, pool));
+
+    matrix.Get(1000, 500) = 1;
+    EXPECT_FALSE(matrix_ops::ParallelReduce(matrix, false, any_negative, pool));
+    EXPECT_TRUE(matrix_ops::ParallelReduce(matrix, true, all_positive, pool));
+}
@@ -0,0 +1,190 @@
+#include "nbkit/matrix_stencil.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::EdgePolicy;
+using nbkit::FixedMatrix;
+using nbkit::Matrix;
+using nbkit::ThreadPool;
+namespace matrix_ops = nbkit::matrix_ops;
+
+namespace
+{
+    template <typename T>
+    Matrix<T> MakeMatrix(size_t width, size_t height)
+    {
+        Matrix<T> matrix;
+        matrix.Resize(width, height);
+        for (size_t y = 0; y < height; ++y)
+            for (size_t x = 0; x < width; ++x)
+                matrix.Get(x, y) = static_cast<T>((x * 7 + y * 13) % 23) - T(11);
+        return matrix;
+    }
+
+    // straightforward convolution with explicit edge handling
+    template <EdgePolicy Edge, typename T, size_t KernelWidth, size_t KernelHeight>
+    Matrix<T> ReferenceConvolve(const Matrix<T>& in, const FixedMatrix<T, KernelWidth, KernelHeight>& kernel)
+    {
+        const auto width = static_cast<std::ptrdiff_t>(in.GetSizeX());
+        const auto height = static_cast<std::ptrdiff_t>(in.GetSizeY());
+        Matrix<T> out;
+        out.Resize(in.GetSizeX(), in.GetSizeY());
+
+        for (std::ptrdiff_t y = 0; y < height; ++y)
+            for (std::ptrdiff_t x = 0; x < width; ++x)
+            {
+                T sum {};
+                for (std::ptrdiff_t j = 0; j < static_cast<std::ptrdiff_t>(KernelHeight); ++j)
+                    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(KernelWidth); ++i)
+                    {
+                        std::ptrdiff_t sx = x + i - static_cast<std::ptrdiff_t>(KernelWidth / 2);
+                        std::ptrdiff_t sy = y + j - static_cast<std::ptrdiff_t>(KernelHeight / 2);
+                        if (Edge == EdgePolicy::kZero && (sx < 0 || sx >= width || sy < 0 || sy >= height))
+                            continue;
+                        if (Edge == EdgePolicy::kClamp)
+                        {
+                            sx = std::clamp<std::ptrdiff_t>(sx, 0, width - 1);
+                            sy = std::clamp<std::ptrdiff_t>(sy, 0, height - 1);
+                        }
+                        else
+                        {
+                            sx = (sx % width + width) % width;
+                            sy = (sy % height + height) % height;
+                        }
+                        sum += kernel.Get(i, j) * in.Get(sx, sy);
+                    }
+                out.Get(x, y) = sum;
+            }
+        return out;
+    }
+
+    template <typename T, typename Layout>
+    std::vector<T> GetElements(const Matrix<T, Layout>& matrix) { return std::vector<T>(matrix.begin(), matrix.end()); }
+}
+
+template <typename Edge>
+class MatrixStencilEdgeTest : public ::testing::Test
+{
+};
+
+template <EdgePolicy Edge>
+using EdgeConstant = std::integral_constant<EdgePolicy, Edge>;
+using EdgePolicies = ::testing::Types<EdgeConstant<EdgePolicy::kClamp>, EdgeConstant<EdgePolicy::kWrap>, EdgeConstant<EdgePolicy::kZero>>;
+TYPED_TEST_SUITE(MatrixStencilEdgeTest, EdgePolicies);
+
+// integer sums are exact, so both the direct and the separable paths must match the reference
+TYPED_TEST(MatrixStencilEdgeTest, ConvolveMatchesReference)
+{
+    constexpr EdgePolicy kEdge = TypeParam::value;
+    const auto in = MakeMatrix<int>(19, 11);
+    const FixedMatrix<int, 3, 3> sharpen({ 0, -1, 0, -1, 5, -1, 0, -1, 0 });
+    const FixedMatrix<int, 5, 3> binomial({ 1, 4, 6, 4, 1, 2, 8, 12, 8, 2, 1, 4, 6, 4, 1 });
+    const FixedMatrix<int, 2, 4> even({ 1, 2, 3, 4, 5, 6, 7, 8 });
+    Matrix<int> out;
+
+    matrix_ops::Convolve<kEdge>(in, sharpen, out);
+    EXPECT_EQ(GetElements(out), GetElements(ReferenceConvolve<kEdge>(in, sharpen)));
+
+    matrix_ops::Convolve<kEdge>(in, binomial, out);
+    EXPECT_EQ(GetElements(out), GetElements(ReferenceConvolve<kEdge>(in, binomial)));
+
+    matrix_ops::Convolve<kEdge>(in, even, out);
+    EXPECT_EQ(GetElements(out), GetElements(ReferenceConvolve<kEdge>(in, even)));
+}
+
+TYPED_TEST(MatrixStencilEdgeTest, InPlaceMatchesOutOfPlace)
+{
+    constexpr EdgePolicy kEdge = TypeParam::value;
+    const FixedMatrix<int, 5, 5> kernel({ 1, 0, 2, 0, 1, 0, 3, 0, 3, 0, 2, 0, -4, 0, 2, 0, 3, 0, 3, 0, 1, 0, 2, 0, 1 });
+    Matrix<int> matrix = MakeMatrix<int>(13, 9);
+    const Matrix<int> expected = ReferenceConvolve<kEdge>(matrix, kernel);
+
+    Matrix<int> parallel = matrix;
+    matrix_ops::Convolve<kEdge>(matrix, kernel, matrix);
+    EXPECT_EQ(GetElements(matrix), GetElements(expected));
+
+    ThreadPool pool(2);
+    matrix_ops::ParallelConvolve<kEdge>(parallel, kernel, parallel, pool);
+    EXPECT_EQ(GetElements(parallel), GetElements(expected));
+}
+
+TEST(MatrixStencilTest, SeparableFloatKernelIsClose)
+{
+    const auto in = MakeMatrix<float>(40, 30);
+    const FixedMatrix<float, 3, 3> blur({ 1 / 16.f, 2 / 16.f, 1 / 16.f, 2 / 16.f, 4 / 16.f, 2 / 16.f, 1 / 16.f, 2 / 16.f, 1 / 16.f });
+    Matrix<float> out;
+
+    matrix_ops::Convolve(in, blur, out);
+
+    const Matrix<float> expected = ReferenceConvolve<EdgePolicy::kClamp>(in, blur);
+    for (size_t y = 0; y < in.GetSizeY(); ++y)
+        for (size_t x = 0; x < in.GetSizeX(); ++x)
+            EXPECT_NEAR(out.Get(x, y), expected.Get(x, y), 1e-5f);
+}
+
+TEST(MatrixStencilTest, ParallelIsBitIdentical)
+{
+    ThreadPool pool(3);
+    const auto in = MakeMatrix<float>(300, 700);
+    const FixedMatrix<float, 3, 5> kernel({ 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f });
+    Matrix<float> serial;
+    Matrix<float> parallel;
+
+    matrix_ops::Convolve<EdgePolicy::kWrap>(in, kernel, serial);
+    matrix_ops::ParallelConvolve<EdgePolicy::kWrap>(in, kernel, parallel, pool);
+
+    EXPECT_EQ(GetElements(serial), GetElements(parallel));
+}
+
+TEST(MatrixStencilTest, PaddedLayoutMatchesRowMajor)
+{
+    const auto in = MakeMatrix<float>(21, 8);
+    nbkit::Matrix<float, nbkit::PaddedLayout<16>> padded_in;
+    padded_in.Resize(21, 8);
+    std::copy(in.begin(), in.end(), padded_in.begin());
+    const FixedMatrix<float, 3, 3> kernel({ 1, 2, 3, 4, 5, 6, 7, 8, 10 });
+    Matrix<float> out;
+    nbkit::Matrix<float, nbkit::PaddedLayout<16>> padded_out;
+
+    matrix_ops::Convolve(in, kernel, out);
+    matrix_ops::Convolve(padded_in, kernel, padded_out);
+
+    EXPECT_EQ(GetElements(padded_out), GetElements(out));
+}
+
+TEST(MatrixStencilTest, GameOfLifeBlinkerOscillates)
+{
+    Matrix<int> board;
+    board.Resize(5, 5);
+    board.Get(1, 2) = board.Get(2, 2) = board.Get(3, 2) = 1;
+    const std::vector<int> horizontal = GetElements(board);
+
+    const auto step = [](const matrix_ops::StencilWindow<int, 3, 3>& window)
+    {
+        int neighbours = -window.Get(0, 0);
+        for (std::ptrdiff_t dy = -1; dy <= 1; ++dy)
+            for (std::ptrdiff_t dx = -1; dx <= 1; ++dx)
+                neighbours += window.Get(dx, dy);
+        return neighbours == 3 || (neighbours == 2 && window.Get(0, 0) == 1) ? 1 : 0;
+    };
+
+    matrix_ops::Stencil<3, 3, EdgePolicy::kZero>(board, board, step);
+    EXPECT_EQ(board.Get(2, 1) + board.Get(2, 2) + board.Get(2, 3), 3);
+    EXPECT_EQ(board.Get(1, 2) + board.Get(3, 2), 0);
+
+    ThreadPool pool(2);
+    matrix_ops::ParallelStencil<3, 3, EdgePolicy::kZero>(board, board, step, pool);
+    EXPECT_EQ(GetElements(board), horizontal);
+}
+
+TEST(MatrixStencilTest, StencilWrapsAroundEdges)
+{
+    const Matrix<int> in(4, std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    Matrix<int> out;
+
+    // left neighbour, and the one above
+    matrix_ops::Stencil<3, 3, EdgePolicy::kWrap>(in, out, [](const auto& window) { return window.Get(-1, 0) * 10 + window.Get(0, -1); });
+
+    EXPECT_EQ(GetElements(out), (std::vector<int>{ 45, 16, 27, 38, 81, 52, 63, 74 }));
+}
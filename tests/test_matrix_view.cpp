@@ -0,0 +1,87 @@
+#include "nbkit/matrix.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+using nbkit::Matrix;
+using nbkit::MatrixView;
+using nbkit::StridedSpan;
+
+static_assert(std::ranges::random_access_range<StridedSpan<int>>);
+static_assert(std::ranges::random_access_range<MatrixView<int>>);
+static_assert(std::ranges::borrowed_range<MatrixView<const int>>);
+
+class MatrixViewTest : public ::testing::Test
+{
+protected:
+    // 4x3, element (x, y) is 10 * y + x
+    Matrix<int> matrix_ { 4, std::vector<int>{ 0, 1, 2, 3, 10, 11, 12, 13, 20, 21, 22, 23 } };
+};
+
+TEST_F(MatrixViewTest, RowIsContiguousSpan)
+{
+    const std::span<int> row = matrix_.Row(1);
+
+    EXPECT_EQ(row.size(), 4);
+    EXPECT_EQ(row.data(), &matrix_.Get(0, 1));
+    EXPECT_EQ(std::vector<int>(row.begin(), row.end()), (std::vector<int>{ 10, 11, 12, 13 }));
+}
+
+TEST_F(MatrixViewTest, ColWalksWithRowStride)
+{
+    const StridedSpan<int> col = matrix_.Col(2);
+
+    EXPECT_EQ(col.GetSize(), 3);
+    EXPECT_EQ(col.GetStride(), 4);
+    EXPECT_FALSE(col.IsContiguous());
+    EXPECT_EQ(std::vector<int>(col.begin(), col.end()), (std::vector<int>{ 2, 12, 22 }));
+    EXPECT_EQ(col[2], 22);
+}
+
+TEST_F(MatrixViewTest, ColWorksWithRangesAlgorithms)
+{
+    const StridedSpan<int> col = matrix_.Col(0);
+    std::ranges::sort(col, std::greater<>());
+
+    EXPECT_EQ(matrix_.Get(0, 0), 20);
+    EXPECT_EQ(matrix_.Get(0, 2), 0);
+    EXPECT_EQ(matrix_.Get(1, 0), 1);
+}
+
+TEST_F(MatrixViewTest, SubMatrixSharesStorage)
+{
+    const MatrixView<int> sub = matrix_.SubMatrix(1, 1, 2, 2);
+
+    EXPECT_EQ(sub.GetSizeX(), 2);
+    EXPECT_EQ(sub.GetSizeY(), 2);
+    EXPECT_EQ(sub.GetRowStride(), 4);
+    EXPECT_FALSE(sub.IsContiguous());
+    EXPECT_EQ(std::vector<int>(sub.begin(), sub.end()), (std::vector<int>{ 11, 12, 21, 22 }));
+
+    std::ranges::fill(sub, 0);
+    EXPECT_EQ(std::accumulate(matrix_.begin(), matrix_.end(), 0), 0 + 1 + 2 + 3 + 10 + 13 + 20 + 23);
+}
+
+TEST_F(MatrixViewTest, NestedSubMatrixRowsAndCols)
+{
+    const MatrixView<int> sub = matrix_.SubMatrix(1, 0, 3, 3).SubMatrix(1, 1, 2, 2);
+
+    EXPECT_EQ(sub.Get(0, 0), 12);
+    EXPECT_EQ(sub.Row(1)[1], 23);
+    EXPECT_EQ(sub.Col(1)[0], 13);
+}
+
+TEST_F(MatrixViewTest, ConstMatrixGivesConstViews)
+{
+    const Matrix<int>& matrix = matrix_;
+
+    const std::span<const int> row = matrix.Row(2);
+    const MatrixView<const int> view = matrix.AsView();
+
+    EXPECT_EQ(row[3], 23);
+    EXPECT_TRUE(view.IsContiguous());
+    EXPECT_EQ(std::ranges::max(view), 23);
+}
@@ -0,0 +1,100 @@
+#include "nbkit/mpsc_ring_buffer.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+template<typename T, size_t Capacity>
+using MpscRingBuffer = nbkit::MpscRingBuffer<T, Capacity>;
+
+class MpscRingBufferTest : public ::testing::Test
+{
+};
+
+TEST_F(MpscRingBufferTest, PopOnEmptyFails)
+{
+    MpscRingBuffer<int, 4> queue;
+    int value = 0;
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST_F(MpscRingBufferTest, FifoOrder)
+{
+    MpscRingBuffer<int, 8> queue;
+    for (int i = 0; i < 5; ++i)
+        EXPECT_TRUE(queue.TryPush(i));
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST_F(MpscRingBufferTest, PushOnFullFails)
+{
+    MpscRingBuffer<int, 4> queue;
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_FALSE(queue.TryPush(4));
+
+    int value = -1;
+    EXPECT_TRUE(queue.TryPop(value));
+    EXPECT_TRUE(queue.TryPush(4));
+}
+
+TEST_F(MpscRingBufferTest, WrapsAround)
+{
+    MpscRingBuffer<int, 4> queue;
+    int value = -1;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(queue.TryPush(i));
+        EXPECT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST_F(MpscRingBufferTest, MultipleProducersDeliverEverything)
+{
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 10000;
+    MpscRingBuffer<int, 64> queue;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < kPerProducer; ++i)
+                while (!queue.TryPush(p * kPerProducer + i))
+                    std::this_thread::yield();
+        });
+    }
+
+    // values of a single producer must come out in order
+    std::vector<int> last_seen(kProducers, -1);
+    int received = 0;
+    int value = 0;
+    while (received < kProducers * kPerProducer)
+    {
+        if (!queue.TryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const int producer = value / kPerProducer;
+        EXPECT_GT(value % kPerProducer, last_seen[producer]);
+        last_seen[producer] = value % kPerProducer;
+        ++received;
+    }
+
+    for (auto& producer : producers)
+        producer.join();
+
+    EXPECT_FALSE(queue.TryPop(value));
+}
@@ -0,0 +1,165 @@
+#include "nbkit/simd.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+using nbkit::simd::GetSimdLevel;
+using nbkit::simd::GetSupportedSimdLevel;
+using nbkit::simd::SetSimdLevel;
+using nbkit::simd::SimdLevel;
+
+namespace
+{
+    constexpr SimdLevel kLevels[] = { SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kAvx512 };
+
+    // sizes around the vector widths and the 32 lanes of the reductions, to go through every tail
+    constexpr size_t kSizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 100, 1023 };
+
+    template <typename T>
+    std::vector<T> MakeValues(size_t n, uint32_t seed)
+    {
+        std::mt19937 engine(seed);
+        std::vector<T> values(n);
+        for (auto& value : values)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                value = std::uniform_real_distribution<T>(-1000, 1000)(engine);
+            else
+                value = std::uniform_int_distribution<T>(std::numeric_limits<T>::min(), std::numeric_limits<T>::max())(engine);
+        }
+        return values;
+    }
+
+    template <typename T>
+    bool AreBitIdentical(const T& a, const T& b) { return std::memcmp(&a, &b, sizeof(T)) == 0; }
+
+    template <typename T>
+    bool AreBitIdentical(const std::vector<T>& a, const std::vector<T>& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+    }
+
+    // runs compute at every level the cpu supports and checks the results against the scalar one
+    template <typename Compute>
+    void ExpectSameAtEveryLevel(Compute compute)
+    {
+        SetSimdLevel(SimdLevel::kScalar);
+        const auto expected = compute();
+
+        for (SimdLevel level : kLevels)
+        {
+            if (SetSimdLevel(level) != level)
+                continue;
+            EXPECT_TRUE(AreBitIdentical(compute(), expected)) << "level " << static_cast<int>(level);
+        }
+        SetSimdLevel(GetSupportedSimdLevel());
+    }
+}
+
+template <typename T>
+class SimdTypedTest : public ::testing::Test {};
+
+using SimdTypes = ::testing::Types<float, int32_t, double>;
+TYPED_TEST_SUITE(SimdTypedTest, SimdTypes);
+
+TYPED_TEST(SimdTypedTest, ElementwiseMatchesScalar)
+{
+    using T = TypeParam;
+
+    for (size_t n : kSizes)
+    {
+        const auto a = MakeValues<T>(n, 1);
+        const auto b = MakeValues<T>(n, 2);
+        const auto c = MakeValues<T>(n, 3);
+
+        ExpectSameAtEveryLevel([&] { std::vector<T> out(n); nbkit::simd::Add(a.data(), b.data(), out.data(), n); return out; });
+        ExpectSameAtEveryLevel([&] { std::vector<T> out(n); nbkit::simd::Scale(a.data(), T(3), out.data(), n); return out; });
+        ExpectSameAtEveryLevel([&] { std::vector<T> out(n); nbkit::simd::ScaleAdd(a.data(), T(3), b.data(), out.data(), n); return out; });
+        ExpectSameAtEveryLevel([&] { std::vector<T> out(n); nbkit::simd::MultiplyAdd(a.data(), b.data(), c.data(), out.data(), n); return out; });
+        ExpectSameAtEveryLevel([&] { std::vector<T> out(n); nbkit::simd::Clamp(a.data(), T(-100), T(100), out.data(), n); return out; });
+    }
+}
+
+TYPED_TEST(SimdTypedTest, ReductionsMatchScalar)
+{
+    using T = TypeParam;
+
+    for (size_t n : kSizes)
+    {
+        const auto a = MakeValues<T>(n, 4);
+        const auto b = MakeValues<T>(n, 5);
+
+        ExpectSameAtEveryLevel([&] { return nbkit::simd::Sum(a.data(), n); });
+        ExpectSameAtEveryLevel([&] { return nbkit::simd::Min(a.data(), n); });
+        ExpectSameAtEveryLevel([&] { return nbkit::simd::Max(a.data(), n); });
+        ExpectSameAtEveryLevel([&] { return nbkit::simd::Dot(a.data(), b.data(), n); });
+    }
+}
+
+TEST(SimdTest, IntegerMultiplyMatchesScalar)
+{
+    // 11 x 70 by 70 x 45, sizes that leave partial tiles at every level
+    const auto a = MakeValues<int32_t>(11 * 70, 6);
+    const auto b = MakeValues<int32_t>(70 * 45, 7);
+
+    ExpectSameAtEveryLevel([&]
+    {
+        std::vector<int32_t> out(11 * 45);
+        nbkit::simd::Multiply(a.data(), b.data(), out.data(), 11, 70, 45);
+        return out;
+    });
+}
+
+TEST(SimdTest, ResultsAreCorrect)
+{
+    const std::vector<float> a { 1.f, -2.f, 3.f, 4.f, 5.f, -6.f, 7.f, 8.f, 9.f, 10.f };
+    const std::vector<float> b { 2.f, 2.f, 2.f, 2.f, 2.f, 2.f, 2.f, 2.f, 2.f, 2.f };
+    std::vector<float> out(a.size());
+
+    for (SimdLevel level : kLevels)
+    {
+        SetSimdLevel(level);
+
+        EXPECT_EQ(nbkit::simd::Sum(a.data(), a.size()), 39.f);
+        EXPECT_EQ(nbkit::simd::Min(a.data(), a.size()), -6.f);
+        EXPECT_EQ(nbkit::simd::Max(a.data(), a.size()), 10.f);
+        EXPECT_EQ(nbkit::simd::Dot(a.data(), b.data(), a.size()), 78.f);
+
+        nbkit::simd::MultiplyAdd(a.data(), b.data(), b.data(), out.data(), a.size());
+        EXPECT_EQ(out[1], -2.f);
+        EXPECT_EQ(out[9], 22.f);
+
+        nbkit::simd::ScaleAdd(a.data(), 3.f, b.data(), out.data(), a.size());
+        EXPECT_EQ(out[1], -4.f);
+        EXPECT_EQ(out[9], 32.f);
+
+        nbkit::simd::Clamp(a.data(), 0.f, 5.f, out.data(), a.size());
+        EXPECT_EQ(out, (std::vector<float>{ 1.f, 0.f, 3.f, 4.f, 5.f, 0.f, 5.f, 5.f, 5.f, 5.f }));
+    }
+    SetSimdLevel(GetSupportedSimdLevel());
+}
+
+TEST(SimdTest, EmptyReductionsReturnIdentities)
+{
+    const float* none = nullptr;
+
+    EXPECT_EQ(nbkit::simd::Sum(none, 0), 0.f);
+    EXPECT_EQ(nbkit::simd::Min(none, 0), std::numeric_limits<float>::infinity());
+    EXPECT_EQ(nbkit::simd::Max(none, 0), -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(nbkit::simd::Max(static_cast<const int32_t*>(nullptr), 0), std::numeric_limits<int32_t>::lowest());
+}
+
+TEST(SimdTest, SetSimdLevelIsCappedToSupported)
+{
+    EXPECT_EQ(SetSimdLevel(SimdLevel::kAvx512), GetSupportedSimdLevel());
+    EXPECT_EQ(GetSimdLevel(), GetSupportedSimdLevel());
+
+    EXPECT_EQ(SetSimdLevel(SimdLevel::kScalar), SimdLevel::kScalar);
+    EXPECT_EQ(GetSimdLevel(), SimdLevel::kScalar);
+    SetSimdLevel(GetSupportedSimdLevel());
+}
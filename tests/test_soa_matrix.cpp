@@ -0,0 +1,68 @@
+#include "nbkit/soa_matrix.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+using nbkit::SoaMatrix;
+
+// height, type, visited
+using CellMatrix = SoaMatrix<float, uint8_t, uint8_t>;
+
+class SoaMatrixTest : public ::testing::Test
+{
+};
+
+TEST_F(SoaMatrixTest, SizedConstructorValueInitializes)
+{
+    const CellMatrix matrix(4, 3);
+
+    EXPECT_EQ(matrix.GetSizeX(), 4);
+    EXPECT_EQ(matrix.GetSizeY(), 3);
+    EXPECT_EQ(matrix.Get(3, 2), std::make_tuple(0.0f, uint8_t { 0 }, uint8_t { 0 }));
+}
+
+TEST_F(SoaMatrixTest, GetProxyWritesEachPlane)
+{
+    CellMatrix matrix(4, 3);
+
+    auto [height, type, visited] = matrix.Get(1, 2);
+    height = 2.5f;
+    type = 7;
+    matrix.Get(2, 0) = std::make_tuple(1.0f, uint8_t { 3 }, uint8_t { 1 });
+
+    EXPECT_EQ(matrix.GetPlane<0>().Get(1, 2), 2.5f);
+    EXPECT_EQ(matrix.Get<1>(1, 2), 7);
+    EXPECT_EQ(matrix.Get<2>(1, 2), 0);
+    EXPECT_EQ(matrix.Get<1>(2, 0), 3);
+    EXPECT_EQ(matrix.Get<2>(2, 0), 1);
+}
+
+TEST_F(SoaMatrixTest, PlanesAreContiguous)
+{
+    CellMatrix matrix(5, 4);
+    for (size_t y = 0; y < 4; ++y)
+        for (size_t x = 0; x < 5; ++x)
+            matrix.Get<0>(x, y) = static_cast<float>(y * 5 + x);
+
+    const auto& heights = matrix.GetPlane<0>();
+    EXPECT_EQ(&heights.Get(0, 1), heights.GetData() + 5);
+    EXPECT_EQ(std::accumulate(heights.begin(), heights.end(), 0.0f), 190.0f);
+}
+
+TEST_F(SoaMatrixTest, AppendRowAndResize)
+{
+    CellMatrix matrix;
+    matrix.Resize(3, 0);
+    matrix.AppendRow(1.0f, 2, 0);
+    matrix.AppendRow(3.0f, 4, 1);
+
+    EXPECT_EQ(matrix.GetSizeY(), 2);
+    EXPECT_EQ(matrix.Get(2, 1), std::make_tuple(3.0f, uint8_t { 4 }, uint8_t { 1 }));
+
+    matrix.Resize(4, 2);
+    EXPECT_EQ(matrix.Get(2, 1), std::make_tuple(3.0f, uint8_t { 4 }, uint8_t { 1 }));
+    EXPECT_EQ(matrix.Get(3, 1), std::make_tuple(0.0f, uint8_t { 0 }, uint8_t { 0 }));
+}
@@ -0,0 +1,100 @@
+#include "nbkit/sparse_matrix.h"
+
+#include <gtest/gtest.h>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using nbkit::Matrix;
+using nbkit::SparseMatrix;
+
+class SparseMatrixTest : public ::testing::Test
+{
+};
+
+TEST_F(SparseMatrixTest, UnsetCellsReadDefault)
+{
+    const SparseMatrix<int> matrix(1000, 1000, -1);
+
+    EXPECT_EQ(matrix.GetSizeX(), 1000);
+    EXPECT_EQ(matrix.Get(999, 999), -1);
+    EXPECT_EQ(matrix.GetCount(), 0);
+    EXPECT_EQ(matrix.GetBlockCount(), 0);
+}
+
+TEST_F(SparseMatrixTest, SetAllocatesOneBlockPerArea)
+{
+    SparseMatrix<int> matrix(1000, 1000);
+    matrix.Set(0, 0, 1);
+    matrix.Set(7, 7, 2);
+    matrix.Set(8, 0, 3);
+    matrix.Set(500, 900, 4);
+
+    EXPECT_EQ(matrix.Get(7, 7), 2);
+    EXPECT_EQ(matrix.Get(8, 0), 3);
+    EXPECT_EQ(matrix.Get(500, 900), 4);
+    EXPECT_EQ(matrix.Get(1, 0), 0);
+    EXPECT_FALSE(matrix.IsSet(1, 0));
+    EXPECT_EQ(matrix.GetCount(), 4);
+    EXPECT_EQ(matrix.GetBlockCount(), 3);
+}
+
+TEST_F(SparseMatrixTest, EraseFreesEmptyBlocks)
+{
+    SparseMatrix<int> matrix(100, 100, 5);
+    matrix.Set(3, 4, 1);
+    matrix.GetOrCreate(4, 4) += 10;
+
+    EXPECT_EQ(matrix.Get(4, 4), 15);
+
+    matrix.Erase(3, 4);
+    EXPECT_EQ(matrix.Get(3, 4), 5);
+    EXPECT_EQ(matrix.GetBlockCount(), 1);
+
+    matrix.Erase(4, 4);
+    EXPECT_EQ(matrix.GetCount(), 0);
+    EXPECT_EQ(matrix.GetBlockCount(), 0);
+}
+
+TEST_F(SparseMatrixTest, ForEachVisitsSetCellsOnly)
+{
+    SparseMatrix<int> matrix(64, 64);
+    matrix.Set(1, 2, 10);
+    matrix.Set(63, 0, 20);
+    matrix.Set(30, 40, 30);
+
+    std::set<std::tuple<size_t, size_t, int>> visited;
+    matrix.ForEach([&](size_t x, size_t y, int value) { visited.emplace(x, y, value); });
+
+    EXPECT_EQ(visited, (std::set<std::tuple<size_t, size_t, int>>{ { 1, 2, 10 }, { 63, 0, 20 }, { 30, 40, 30 } }));
+}
+
+TEST_F(SparseMatrixTest, DenseRoundTrip)
+{
+    const Matrix<int> dense(4, std::vector<int>{ 0, 0, 3, 0, 0, 0, 0, 0, 7, 0, 0, 9 });
+
+    const auto sparse = SparseMatrix<int>::FromMatrix(dense);
+    EXPECT_EQ(sparse.GetSizeY(), 3);
+    EXPECT_EQ(sparse.GetCount(), 3);
+    EXPECT_EQ(sparse.Get(0, 2), 7);
+
+    const Matrix<int> back = sparse.ToMatrix();
+    EXPECT_EQ(std::vector<int>(back.begin(), back.end()), std::vector<int>(dense.begin(), dense.end()));
+}
+
+TEST_F(SparseMatrixTest, FarBlocksOfHugeGridsStayDistinct)
+{
+    // 2^32 blocks a side, the largest grid block keys can address
+    const size_t side = size_t { 1 } << 35;
+    SparseMatrix<int> matrix(side, side);
+
+    matrix.Set(side - 1, 0, 1);
+    matrix.Set(0, side - 1, 2);
+    matrix.Set(side - 1, side - 1, 3);
+
+    EXPECT_EQ(matrix.GetBlockCount(), 3);
+    EXPECT_EQ(matrix.Get(side - 1, 0), 1);
+    EXPECT_EQ(matrix.Get(0, side - 1), 2);
+    EXPECT_EQ(matrix.Get(side - 1, side - 1), 3);
+    EXPECT_EQ(matrix.Get(0, 0), 0);
+}
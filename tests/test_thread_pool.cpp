@@ -0,0 +1,52 @@
+#include "nbkit/thread_pool.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <vector>
+
+using nbkit::ThreadPool;
+
+TEST(ThreadPoolTest, RunsEveryIterationOnce)
+{
+    for (size_t threads : { 0, 1, 3 })
+    {
+        ThreadPool pool(threads);
+        std::vector<std::atomic<int>> runs(1000);
+
+        pool.ParallelFor(runs.size(), [&](size_t i) { runs[i].fetch_add(1, std::memory_order_relaxed); });
+
+        for (const auto& run : runs)
+            EXPECT_EQ(run.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, NestedParallelFor)
+{
+    ThreadPool pool(3);
+    std::atomic<size_t> total { 0 };
+
+    pool.ParallelFor(16, [&](size_t)
+    {
+        pool.ParallelFor(100, [&](size_t i) { total.fetch_add(i, std::memory_order_relaxed); });
+    });
+
+    EXPECT_EQ(total.load(), 16 * 4950);
+}
+
+TEST(ThreadPoolTest, ConcurrentCallers)
+{
+    ThreadPool pool(2);
+    std::atomic<size_t> total { 0 };
+
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 4; ++c)
+        callers.emplace_back([&]()
+        {
+            for (int repeat = 0; repeat < 20; ++repeat)
+                pool.ParallelFor(50, [&](size_t) { total.fetch_add(1, std::memory_order_relaxed); });
+        });
+    for (auto& caller : callers)
+        caller.join();
+
+    EXPECT_EQ(total.load(), 4 * 20 * 50);
+}
@@ -0,0 +1,101 @@
+#include "nbkit/tracked_matrix.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+using nbkit::TrackedMatrix;
+
+namespace
+{
+    using Region = std::tuple<size_t, size_t, size_t, size_t>;
+
+    template <typename Matrix>
+    std::vector<Region> GetDirtyTiles(const Matrix& matrix)
+    {
+        std::vector<Region> tiles;
+        matrix.ForEachDirtyTile([&](size_t x, size_t y, size_t width, size_t height) { tiles.emplace_back(x, y, width, height); });
+        return tiles;
+    }
+}
+
+class TrackedMatrixTest : public ::testing::Test
+{
+protected:
+    // 3 x 2 tiles of 4 x 4, the last column and row of tiles clipped
+    TrackedMatrix<int, 4> matrix_ { 10, 6 };
+
+    void SetUp() override { matrix_.ClearDirty(); }
+};
+
+TEST_F(TrackedMatrixTest, StartsAllDirty)
+{
+    const TrackedMatrix<int, 4> matrix(10, 6);
+
+    EXPECT_EQ(matrix.GetDirtyTileCount(), 6);
+    EXPECT_EQ(GetDirtyTiles(matrix).back(), Region(8, 4, 2, 2));
+}
+
+TEST_F(TrackedMatrixTest, ReadsDontMarkTiles)
+{
+    const auto& const_matrix = matrix_;
+    int sum = const_matrix.Get(5, 5);
+    for (int value : const_matrix)
+        sum += value;
+
+    EXPECT_EQ(sum, 0);
+    EXPECT_EQ(matrix_.GetDirtyTileCount(), 0);
+}
+
+TEST_F(TrackedMatrixTest, GetAndSetMarkTheirTile)
+{
+    matrix_.Get(1, 1) = 3;
+    matrix_.Set(9, 5, 4);
+
+    EXPECT_TRUE(matrix_.IsTileDirty(0, 0));
+    EXPECT_TRUE(matrix_.IsTileDirty(2, 1));
+    EXPECT_EQ(GetDirtyTiles(matrix_), (std::vector<Region>{ { 0, 0, 4, 4 }, { 8, 4, 2, 2 } }));
+    EXPECT_EQ(matrix_.Get(9, 5), 4);
+}
+
+TEST_F(TrackedMatrixTest, ViewsMarkTheirRegion)
+{
+    matrix_.Row(5)[0] = 1;
+    EXPECT_EQ(matrix_.GetDirtyTileCount(), 3);
+
+    matrix_.ClearDirty();
+    matrix_.SubMatrix(3, 2, 2, 3).Get(0, 0) = 1;
+    EXPECT_EQ(GetDirtyTiles(matrix_), (std::vector<Region>{ { 0, 0, 4, 4 }, { 4, 0, 4, 4 }, { 0, 4, 4, 2 }, { 4, 4, 4, 2 } }));
+}
+
+TEST_F(TrackedMatrixTest, IteratorWritesMarkTiles)
+{
+    std::fill(matrix_.begin() + 40, matrix_.begin() + 43, 7);
+
+    EXPECT_EQ(matrix_.Get(0, 4), 7);
+    EXPECT_EQ(GetDirtyTiles(matrix_), (std::vector<Region>{ { 0, 4, 4, 2 } }));
+}
+
+TEST_F(TrackedMatrixTest, ManyTilesSpanBitSetWords)
+{
+    TrackedMatrix<int, 1> matrix(100, 2);
+    matrix.ClearDirty();
+
+    matrix.Set(70, 1, 1);
+    matrix.MarkDirty(0, 0, 2, 1);
+
+    EXPECT_EQ(GetDirtyTiles(matrix), (std::vector<Region>{ { 0, 0, 1, 1 }, { 1, 0, 1, 1 }, { 70, 1, 1, 1 } }));
+}
+
+TEST_F(TrackedMatrixTest, MarkDirtyClipsToMatrix)
+{
+    matrix_.MarkDirty(9, 1, 5, 2);
+    EXPECT_EQ(GetDirtyTiles(matrix_), (std::vector<Region>{ { 8, 0, 2, 4 } }));
+
+    matrix_.ClearDirty();
+    matrix_.MarkDirty(3, 5, 100, 100);
+    matrix_.MarkDirty(0, 6, 4, 4);
+    matrix_.MarkDirty(10, 0, 1, 1);
+    EXPECT_EQ(GetDirtyTiles(matrix_), (std::vector<Region>{ { 0, 4, 4, 2 }, { 4, 4, 4, 2 }, { 8, 4, 2, 2 } }));
+}
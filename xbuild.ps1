@@ -6,7 +6,10 @@ param (
     [Switch]$Debug,
 
     [Alias("t")]
-    [Switch]$Test
+    [Switch]$Test,
+
+    [Alias("b")]
+    [Switch]$Bench
 )
 
 # setup error handling
@@ -30,10 +33,11 @@ conan install . --output-folder=. --build=missing --update -s build_type=$BuildT
 # cmake configuration
 Write-Host "Configuring CMake..." -ForegroundColor Yellow
 $TestFlag = if ($Test) { "ON" } else { "OFF" }
+$BenchFlag = if ($Bench) { "ON" } else { "OFF" }
 
 if ($Test) { Write-Host "[TEST MODE ENABLED]" -ForegroundColor Magenta }
 
-cmake --preset conan-default -DBUILD_TESTING=$TestFlag
+cmake --preset conan-default -DBUILD_TESTING=$TestFlag -DBUILD_BENCHMARKS=$BenchFlag
 
 # build
 Write-Host "Building project ($BuildType)..." -ForegroundColor Yellow
@@ -47,6 +51,12 @@ if ($Test) {
     Write-Host "All tests completed!" -ForegroundColor Green
 }
 
+# benchmarks
+if ($Bench) {
+    Write-Host "`nRunning Benchmarks..." -ForegroundColor Cyan
+    & ".\build\$BuildType\nbkit_bench.exe"
+}
+
 Write-Host "`n[SUCCESS] Build complete!" -ForegroundColor Green
 
 # conan package
@@ -4,13 +4,15 @@ set -e
 BUILD_TYPE="Debug"
 PRESET_NAME="conan-debug"
 TEST=false
+BENCH=false
 
-while getopts "rdt" opt; do
+while getopts "rdtb" opt; do
   case $opt in
     r) BUILD_TYPE="Release"; PRESET_NAME="conan-release" ;;
     d) BUILD_TYPE="Debug";   PRESET_NAME="conan-debug" ;;
     t) TEST=true ;;
-    *) echo "Usage: ./xbuild.sh [-r] [-d] [-t]"; exit 1 ;;
+    b) BENCH=true ;;
+    *) echo "Usage: ./xbuild.sh [-r] [-d] [-t] [-b]"; exit 1 ;;
   esac
 done
 
@@ -22,11 +24,10 @@ conan install . --output-folder=. --build=missing --update -s build_type=$BUILD_
 
 echo "Configuring CMake..."
 
-if [ "$TEST" = true ]; then
-    cmake --preset $PRESET_NAME -DBUILD_TESTING=ON
-else
-    cmake --preset $PRESET_NAME
-fi
+TEST_FLAG=$([ "$TEST" = true ] && echo ON || echo OFF)
+BENCH_FLAG=$([ "$BENCH" = true ] && echo ON || echo OFF)
+
+cmake --preset $PRESET_NAME -DBUILD_TESTING=$TEST_FLAG -DBUILD_BENCHMARKS=$BENCH_FLAG
 
 echo "Building project..."
 
@@ -40,4 +41,9 @@ if [ "$TEST" = true ]; then
     cd ../..
 fi
 
+if [ "$BENCH" = true ]; then
+    echo -e "\nRunning Benchmarks..."
+    ./build/$BUILD_TYPE/nbkit_bench
+fi
+
 echo -e "\n[SUCCESS] Build complete!"
\ No newline at end of file